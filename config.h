@@ -15,6 +15,7 @@
 /*#define CF_FALLBACK_FONT_NAME "-*-helvetica-medium-r-normal-*-12-*-*-*-*-*-*-*"*/
 #define CF_DRAG_TRESHOLD 2
 #define CF_DBLCLICK_DELAY 250
+#define CF_DRAG_RATE 60
 
 #define CF_MAX_MOVERES_STR_SIZE 32
 
@@ -24,6 +25,8 @@
 
 #define CF_EDGE_RESISTANCE 16
 
+#define CF_MOVERES_RATE 60
+
 #define CF_RAISE_DELAY 500
 
 #define CF_STATUSBAR_SYSTRAY_HEIGHT 24
@@ -0,0 +1,198 @@
+/*
+ * ion/de/attrcache.c
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#include <string.h>
+
+#include <libtu/misc.h>
+#include <ioncore/common.h>
+#include "attrcache.h"
+
+
+static uint generation=1;
+
+
+/*{{{ Signatures */
+
+
+static uint spec_hash(uint h, const GrStyleSpec *spec)
+{
+    uint i;
+    
+    if(spec==NULL)
+        return h;
+    
+    for(i=0; i<spec->n; i++){
+        h=(h^(uint)(ulong)spec->attrs[i].attr)*16777619u;
+        h=(h^spec->attrs[i].score)*16777619u;
+    }
+    
+    return h;
+}
+
+
+static uint signature(const void *owner, const GrStyleSpec *a1, 
+                      const GrStyleSpec *a2)
+{
+    uint h=2166136261u^(uint)(((ulong)owner)>>4);
+    
+    h=spec_hash(h, a1);
+    /* Separate a1 and a2 so that moving attributes between them changes
+     * the signature. */
+    h=(h^0xffu)*16777619u;
+    h=spec_hash(h, a2);
+    
+    return h;
+}
+
+
+/* A missing spec scores like an empty one. */
+static bool spec_same(const GrStyleSpec *s1, const GrStyleSpec *s2)
+{
+    uint n1=(s1!=NULL ? s1->n : 0);
+    uint n2=(s2!=NULL ? s2->n : 0);
+    uint i;
+    
+    if(n1!=n2)
+        return FALSE;
+    
+    for(i=0; i<n1; i++){
+        if(s1->attrs[i].attr!=s2->attrs[i].attr ||
+           s1->attrs[i].score!=s2->attrs[i].score){
+            return FALSE;
+        }
+    }
+    
+    return TRUE;
+}
+
+
+/*}}}*/
+
+
+/*{{{ Lookup and storage */
+
+
+void deattrcache_init(DEAttrCache *cache)
+{
+    int i;
+    
+    for(i=0; i<DE_ATTRCACHE_BUCKETS; i++)
+        cache->buckets[i]=NULL;
+    
+    cache->n=0;
+    cache->generation=generation;
+}
+
+
+void deattrcache_flush(DEAttrCache *cache)
+{
+    DEAttrCacheEntry *ent, *next;
+    int i;
+    
+    for(i=0; i<DE_ATTRCACHE_BUCKETS; i++){
+        for(ent=cache->buckets[i]; ent!=NULL; ent=next){
+            next=ent->next;
+            gr_stylespec_unalloc(&ent->a1);
+            gr_stylespec_unalloc(&ent->a2);
+            free(ent);
+        }
+        cache->buckets[i]=NULL;
+    }
+    
+    cache->n=0;
+}
+
+
+static void check_generation(DEAttrCache *cache)
+{
+    if(cache->generation!=generation){
+        deattrcache_flush(cache);
+        cache->generation=generation;
+    }
+}
+
+
+bool deattrcache_lookup(DEAttrCache *cache, const void *owner,
+                        const GrStyleSpec *a1, const GrStyleSpec *a2,
+                        void **ret)
+{
+    DEAttrCacheEntry *ent;
+    uint h;
+    
+    check_generation(cache);
+    
+    h=signature(owner, a1, a2);
+    
+    for(ent=cache->buckets[h%DE_ATTRCACHE_BUCKETS]; ent!=NULL; ent=ent->next){
+        if(ent->hash==h && ent->owner==owner &&
+           spec_same(&ent->a1, a1) && spec_same(&ent->a2, a2)){
+            *ret=ent->value;
+            return TRUE;
+        }
+    }
+    
+    return FALSE;
+}
+
+
+void deattrcache_store(DEAttrCache *cache, const void *owner,
+                       const GrStyleSpec *a1, const GrStyleSpec *a2,
+                       void *value)
+{
+    DEAttrCacheEntry *ent;
+    uint b;
+    
+    check_generation(cache);
+    
+    /* The number of distinct attribute sets in use is small; if it is
+     * not, start over rather than keep track of usage.
+     */
+    if(cache->n>=DE_ATTRCACHE_MAX)
+        deattrcache_flush(cache);
+    
+    ent=ALLOC(DEAttrCacheEntry);
+    
+    if(ent==NULL)
+        return;
+    
+    gr_stylespec_init(&ent->a1);
+    gr_stylespec_init(&ent->a2);
+    
+    if((a1!=NULL && !gr_stylespec_append(&ent->a1, a1)) ||
+       (a2!=NULL && !gr_stylespec_append(&ent->a2, a2))){
+        gr_stylespec_unalloc(&ent->a1);
+        gr_stylespec_unalloc(&ent->a2);
+        free(ent);
+        return;
+    }
+    
+    ent->hash=signature(owner, a1, a2);
+    ent->owner=owner;
+    ent->value=value;
+    
+    b=ent->hash%DE_ATTRCACHE_BUCKETS;
+    ent->next=cache->buckets[b];
+    cache->buckets[b]=ent;
+    cache->n++;
+}
+
+
+void deattrcache_invalidate_all()
+{
+    generation++;
+}
+
+
+uint deattrcache_generation()
+{
+    return generation;
+}
+
+
+/*}}}*/
+
@@ -0,0 +1,58 @@
+/*
+ * ion/de/attrcache.h
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#ifndef ION_DE_ATTRCACHE_H
+#define ION_DE_ATTRCACHE_H
+
+#include <ioncore/common.h>
+#include <ioncore/gr.h>
+
+INTRSTRUCT(DEAttrCache);
+INTRSTRUCT(DEAttrCacheEntry);
+
+
+/* Cache of the results of matching attribute sets (a1, a2) against 
+ * styles or colour groups. All caches are invalidated at once with
+ * deattrcache_invalidate_all() whenever the set of styles or their colour
+ * groups change; each cache notices this lazily on the next lookup.
+ */
+
+#define DE_ATTRCACHE_BUCKETS 32
+#define DE_ATTRCACHE_MAX 128
+
+
+DECLSTRUCT(DEAttrCacheEntry){
+    uint hash;
+    const void *owner;
+    GrStyleSpec a1, a2;
+    void *value;
+    DEAttrCacheEntry *next;
+};
+
+
+DECLSTRUCT(DEAttrCache){
+    DEAttrCacheEntry *buckets[DE_ATTRCACHE_BUCKETS];
+    int n;
+    uint generation;
+};
+
+
+extern void deattrcache_init(DEAttrCache *cache);
+extern void deattrcache_flush(DEAttrCache *cache);
+
+extern bool deattrcache_lookup(DEAttrCache *cache, const void *owner,
+                               const GrStyleSpec *a1, const GrStyleSpec *a2,
+                               void **ret);
+extern void deattrcache_store(DEAttrCache *cache, const void *owner,
+                              const GrStyleSpec *a1, const GrStyleSpec *a2,
+                              void *value);
+
+extern void deattrcache_invalidate_all();
+extern uint deattrcache_generation();
+
+#endif /* ION_DE_ATTRCACHE_H */
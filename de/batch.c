@@ -0,0 +1,351 @@
+/*
+ * ion/de/batch.c
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009.
+ *
+ * See the included file LICENSE for details.
+ */
+
+#include <string.h>
+
+#include <libtu/minmax.h>
+#include <ioncore/common.h>
+#include <ioncore/global.h>
+#include "batch.h"
+#include "font.h"
+#include "gc.h"
+
+
+/*{{{ Batches */
+
+
+enum{
+    DEBATCH_RECTS,
+    DEBATCH_STRINGS
+};
+
+
+INTRSTRUCT(DEBatchString);
+
+DECLSTRUCT(DEBatchString){
+    int x, y;
+    char *str;
+    int len;
+    bool needfill;
+};
+
+
+INTRSTRUCT(DEBatch);
+
+/* Rectangle batches are keyed by (d, gc, colour), string batches by
+ * (brush, colours, needfill). x1, y1, x2, y2 bound everything queued
+ * in the batch.
+ */
+DECLSTRUCT(DEBatch){
+    int kind;
+
+    Drawable d;
+    GC gc;
+    DEColour colour;
+
+    DEBrush *brush;
+    DEColourGroup *colours;
+    bool needfill;
+
+    int x1, y1, x2, y2;
+
+    int n;
+    int rects_alloc, strs_alloc;
+    XRectangle *rects;
+    DEBatchString *strs;
+};
+
+
+/* More batches than this are seldom needed by a single redraw;
+ * when we run out, everything is simply flushed.
+ */
+#define DEBATCH_MAX 16
+
+
+static DEBatch batches[DEBATCH_MAX];
+static int n_batches=0;
+static int depth=0;
+static bool flushing=FALSE;
+
+
+static bool overlaps(const DEBatch *b, int x1, int y1, int x2, int y2)
+{
+    return (x1<b->x2 && b->x1<x2 && y1<b->y2 && b->y1<y2);
+}
+
+
+static bool matches(const DEBatch *b, const DEBatch *key)
+{
+    if(b->kind!=key->kind)
+        return FALSE;
+
+    if(b->kind==DEBATCH_RECTS){
+        return (b->d==key->d && b->gc==key->gc &&
+                b->colour==key->colour);
+    }else{
+        return (b->brush==key->brush && b->colours==key->colours &&
+                b->needfill==key->needfill);
+    }
+}
+
+
+/* A primitive may join an earlier batch only if nothing queued after
+ * that batch overlaps it; otherwise it would be painted in the wrong
+ * order.
+ */
+static DEBatch *get_batch(const DEBatch *key, int x1, int y1, int x2, int y2)
+{
+    DEBatch *b;
+    int i;
+
+    for(i=n_batches-1; i>=0; i--){
+        b=&batches[i];
+        if(matches(b, key))
+            goto found;
+        if(overlaps(b, x1, y1, x2, y2))
+            break;
+    }
+
+    if(n_batches==DEBATCH_MAX)
+        debatch_flush();
+
+    b=&batches[n_batches++];
+    b->kind=key->kind;
+    b->d=key->d;
+    b->gc=key->gc;
+    b->colour=key->colour;
+    b->brush=key->brush;
+    b->colours=key->colours;
+    b->needfill=key->needfill;
+    b->n=0;
+    b->x1=x1;
+    b->y1=y1;
+    b->x2=x2;
+    b->y2=y2;
+
+    return b;
+
+found:
+    b->x1=minof(b->x1, x1);
+    b->y1=minof(b->y1, y1);
+    b->x2=maxof(b->x2, x2);
+    b->y2=maxof(b->y2, y2);
+
+    return b;
+}
+
+
+static bool ensure_space(DEBatch *b, size_t elsize, void **arr,
+                         int *n_alloc)
+{
+    int n;
+    void *p;
+
+    if(b->n<*n_alloc)
+        return TRUE;
+
+    n=(*n_alloc==0 ? 16 : *n_alloc*2);
+
+    p=realloc(*arr, n*elsize);
+
+    if(p==NULL){
+        warn_err();
+        return FALSE;
+    }
+
+    *arr=p;
+    *n_alloc=n;
+
+    return TRUE;
+}
+
+
+/*}}}*/
+
+
+/*{{{ Queueing */
+
+
+void debatch_fill_rect(Drawable d, GC gc, DEColour colour,
+                       int x, int y, int w, int h)
+{
+    DEBatch key, *b;
+    XRectangle *r;
+
+    if(w<=0 || h<=0)
+        return;
+
+    if(depth==0 || flushing){
+        degc_set_foreground(gc, colour);
+        XFillRectangle(ioncore_g.dpy, d, gc, x, y, w, h);
+        return;
+    }
+
+    key.kind=DEBATCH_RECTS;
+    key.d=d;
+    key.gc=gc;
+    key.colour=colour;
+
+    b=get_batch(&key, x, y, x+w, y+h);
+
+    if(!ensure_space(b, sizeof(XRectangle), (void**)&b->rects,
+                     &b->rects_alloc)){
+        debatch_flush();
+        degc_set_foreground(gc, colour);
+        XFillRectangle(ioncore_g.dpy, d, gc, x, y, w, h);
+        return;
+    }
+
+    r=&b->rects[b->n++];
+    r->x=x;
+    r->y=y;
+    r->width=w;
+    r->height=h;
+}
+
+
+/* Returns FALSE if the string should be drawn immediately instead. */
+bool debatch_draw_string(DEBrush *brush, int x, int y,
+                         const char *str, int len, bool needfill,
+                         DEColourGroup *colours)
+{
+    DEBatch key, *b;
+    DEBatchString *s;
+    GrFontExtents fnte;
+    int w, pad;
+    char *copy;
+
+    if(depth==0 || flushing)
+        return FALSE;
+
+    copy=ALLOC_N(char, len+1);
+
+    if(copy==NULL)
+        goto immediate;
+
+    memcpy(copy, str, len);
+
+    debrush_get_font_extents(brush, &fnte);
+    w=debrush_get_text_width(brush, str, len);
+    /* Leave some room for glyphs that stick out of their cell. */
+    pad=fnte.max_height/2;
+
+    key.kind=DEBATCH_STRINGS;
+    key.brush=brush;
+    key.colours=colours;
+    key.needfill=needfill;
+    key.d=None;
+    key.gc=None;
+    key.colour=0;
+
+    b=get_batch(&key, x-pad, y-fnte.baseline,
+                x+w+pad, y-fnte.baseline+fnte.max_height);
+
+    if(!ensure_space(b, sizeof(DEBatchString), (void**)&b->strs,
+                     &b->strs_alloc)){
+        free(copy);
+        goto immediate;
+    }
+
+    s=&b->strs[b->n++];
+    s->x=x;
+    s->y=y;
+    s->str=copy;
+    s->len=len;
+    s->needfill=needfill;
+
+    return TRUE;
+
+immediate:
+    debatch_flush();
+    return FALSE;
+}
+
+
+/*}}}*/
+
+
+/*{{{ Flushing */
+
+
+static void flush_batch(DEBatch *b)
+{
+    int i;
+
+    if(b->kind==DEBATCH_RECTS){
+        degc_set_foreground(b->gc, b->colour);
+        XFillRectangles(ioncore_g.dpy, b->d, b->gc, b->rects, b->n);
+    }else{
+        for(i=0; i<b->n; i++){
+            DEBatchString *s=&b->strs[i];
+            debrush_do_draw_string(b->brush, s->x, s->y, s->str, s->len,
+                                   s->needfill, b->colours);
+            free(s->str);
+        }
+    }
+
+    b->n=0;
+}
+
+
+void debatch_flush()
+{
+    int i;
+
+    if(flushing)
+        return;
+
+    flushing=TRUE;
+
+    for(i=0; i<n_batches; i++){
+        if(batches[i].n>0)
+            flush_batch(&batches[i]);
+    }
+
+    n_batches=0;
+    flushing=FALSE;
+}
+
+
+void debatch_begin()
+{
+    depth++;
+}
+
+
+void debatch_end()
+{
+    debatch_flush();
+
+    if(depth>0)
+        depth--;
+}
+
+
+void debatch_deinit()
+{
+    int i;
+
+    debatch_flush();
+
+    for(i=0; i<DEBATCH_MAX; i++){
+        if(batches[i].rects!=NULL){
+            free(batches[i].rects);
+            batches[i].rects=NULL;
+        }
+        if(batches[i].strs!=NULL){
+            free(batches[i].strs);
+            batches[i].strs=NULL;
+        }
+        batches[i].rects_alloc=0;
+        batches[i].strs_alloc=0;
+    }
+}
+
+
+/*}}}*/
@@ -0,0 +1,37 @@
+/*
+ * ion/de/batch.h
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009.
+ *
+ * See the included file LICENSE for details.
+ */
+
+#ifndef ION_DE_BATCH_H
+#define ION_DE_BATCH_H
+
+#include <ioncore/common.h>
+
+#include "brush.h"
+#include "colour.h"
+
+
+/* Between debrush_begin and debrush_end, filled rectangles and strings
+ * are not drawn immediately but collected in batches keyed by drawable,
+ * GC and colour, so that e.g. the borders of all the tabs of a frame
+ * go out in one XFillRectangles per colour. Anything that draws through
+ * other means must call debatch_flush first.
+ */
+
+extern void debatch_begin();
+extern void debatch_end();
+extern void debatch_flush();
+
+extern void debatch_fill_rect(Drawable d, GC gc, DEColour colour,
+                              int x, int y, int w, int h);
+extern bool debatch_draw_string(DEBrush *brush, int x, int y,
+                                const char *str, int len, bool needfill,
+                                DEColourGroup *colours);
+
+extern void debatch_deinit();
+
+#endif /* ION_DE_BATCH_H */
@@ -21,9 +21,11 @@
 #include "font.h"
 #include "colour.h"
 #include "private.h"
+#include "batch.h"
+#include "shape.h"
 
 
-/*{{{ Brush creation and releasing */
+/*{{{ Brush creation */
 
 
 #define MATCHES(S, A) (gr_stylespec_score(&(S), A)>0)
@@ -38,16 +40,33 @@ static GrStyleSpec tabinfo_spec=GR_STYLESPEC_INIT;
 static GrStyleSpec tabmenuentry_spec=GR_STYLESPEC_INIT;
 
 
-bool debrush_init(DEBrush *brush, Window win,
-                  const GrStyleSpec *spec, DEStyle *style)
+static DEBrushExtrasFn *get_extras_fn(const GrStyleSpec *spec)
 {
-    GrStyleSpec tmp;
+    ENSURE_INITSPEC(tabframe_spec, "tab-frame");
+    ENSURE_INITSPEC(tabinfo_spec, "tab-info");
+    ENSURE_INITSPEC(tabmenuentry_spec, "tab-menuentry");
+    
+    if(MATCHES(tabframe_spec, spec) || MATCHES(tabinfo_spec, spec))
+        return debrush_tab_extras;
+    else if(MATCHES(tabmenuentry_spec, spec))
+        return debrush_menuentry_extras;
     
+    return NULL;
+}
+
+
+static bool debrush_do_init(DEBrush *brush, Window win, DEStyle *style,
+                            DEBrushExtrasFn *extras_fn)
+{
     brush->d=style;
-    brush->extras_fn=NULL;
+    brush->extras_fn=extras_fn;
     brush->indicator_w=0;
     brush->win=win;
     brush->clip_set=FALSE;
+    brush->buffer=NULL;
+#ifdef HAVE_X11_XFT
+    brush->draw=NULL;
+#endif
     
     gr_stylespec_init(&brush->current_attr);
     
@@ -58,16 +77,10 @@ bool debrush_init(DEBrush *brush, Window win,
         return FALSE;
     }
     
-    ENSURE_INITSPEC(tabframe_spec, "tab-frame");
-    ENSURE_INITSPEC(tabinfo_spec, "tab-info");
-    ENSURE_INITSPEC(tabmenuentry_spec, "tab-menuentry");
-    
-    if(MATCHES(tabframe_spec, spec) || MATCHES(tabinfo_spec, spec)){
-        brush->extras_fn=debrush_tab_extras;
+    if(extras_fn==debrush_tab_extras){
         if(!style->tabbrush_data_ok)
             destyle_create_tab_gcs(style);
-    }else if(MATCHES(tabmenuentry_spec, spec)){
-        brush->extras_fn=debrush_menuentry_extras;
+    }else if(extras_fn==debrush_menuentry_extras){
         brush->indicator_w=grbrush_get_text_width((GrBrush*)brush, 
                                                   DE_SUB_IND, 
                                                   DE_SUB_IND_LEN);
@@ -77,18 +90,80 @@ bool debrush_init(DEBrush *brush, Window win,
 }
 
 
+bool debrush_init(DEBrush *brush, Window win,
+                  const GrStyleSpec *spec, DEStyle *style)
+{
+    return debrush_do_init(brush, win, style, get_extras_fn(spec));
+}
+
+
 DEBrush *create_debrush(Window win, const GrStyleSpec *spec, DEStyle *style)
 {
     CREATEOBJ_IMPL(DEBrush, debrush, (p, win, spec, style));
 }
 
 
-static DEBrush *do_get_brush(Window win, WRootWin *rootwin, 
-                             const char *stylename, bool slave)
-{
+/*}}}*/
+
+
+/*{{{ Shared brush data */
+
+
+/* Everything that brushes of the same style name on the same root
+ * window have in common is resolved once and kept here: the style 
+ * (with its font, GCs and colour groups) and the kind of extras. 
+ * Brushes themselves only add the window and drawing state. Entries
+ * hold a reference to their style, and are dropped whenever the set
+ * of styles changes.
+ */
+
+INTRSTRUCT(DEBrushShared);
+
+DECLSTRUCT(DEBrushShared){
+    char *stylename;
+    WRootWin *rootwin;
     DEStyle *style;
-    DEBrush *brush;
+    DEBrushExtrasFn *extras_fn;
+    DEBrushShared *next, *prev;
+};
+
+
+static DEBrushShared *shared_brushes=NULL;
+static uint shared_generation=0;
+
+
+void debrush_flush_shared()
+{
+    DEBrushShared *sh;
+    
+    while(shared_brushes!=NULL){
+        sh=shared_brushes;
+        UNLINK_ITEM(shared_brushes, sh, next, prev);
+        destyle_unref(sh->style);
+        free(sh->stylename);
+        free(sh);
+    }
+}
+
+
+static DEBrushShared *get_shared(WRootWin *rootwin, const char *stylename)
+{
+    DEBrushShared *sh;
     GrStyleSpec spec;
+    DEStyle *style;
+    
+    /* Style definitions are over once brushes are wanted again. */
+    de_drop_old_styles();
+    
+    if(shared_generation!=deattrcache_generation()){
+        debrush_flush_shared();
+        shared_generation=deattrcache_generation();
+    }
+    
+    for(sh=shared_brushes; sh!=NULL; sh=sh->next){
+        if(sh->rootwin==rootwin && strcmp(sh->stylename, stylename)==0)
+            return sh;
+    }
     
     if(!gr_stylespec_load(&spec, stylename))
         return NULL;
@@ -100,10 +175,67 @@ static DEBrush *do_get_brush(Window win, WRootWin *rootwin,
         return NULL;
     }
     
-    brush=create_debrush(win, &spec, style);
-
+    sh=ALLOC(DEBrushShared);
+    
+    if(sh==NULL){
+        warn_err();
+        gr_stylespec_unalloc(&spec);
+        return NULL;
+    }
+    
+    sh->stylename=scopy(stylename);
+    
+    if(sh->stylename==NULL){
+        free(sh);
+        gr_stylespec_unalloc(&spec);
+        return NULL;
+    }
+    
+    sh->rootwin=rootwin;
+    sh->style=style;
+    sh->extras_fn=get_extras_fn(&spec);
+    style->usecount++;
+    
     gr_stylespec_unalloc(&spec);
     
+    LINK_ITEM_FIRST(shared_brushes, sh, next, prev);
+    
+    return sh;
+}
+
+
+static bool debrush_shared_init(DEBrush *brush, Window win, 
+                                DEBrushShared *sh)
+{
+    return debrush_do_init(brush, win, sh->style, sh->extras_fn);
+}
+
+
+static DEBrush *create_debrush_shared(Window win, DEBrushShared *sh)
+{
+    CREATEOBJ_IMPL(DEBrush, debrush_shared, (p, win, sh));
+}
+
+
+/*}}}*/
+
+
+/*{{{ Brush lookup and releasing */
+
+
+static DEBrush *do_get_brush(Window win, WRootWin *rootwin, 
+                             const char *stylename, bool slave)
+{
+    DEBrushShared *sh;
+    DEBrush *brush;
+    
+    sh=get_shared(rootwin, stylename);
+    
+    if(sh==NULL)
+        return NULL;
+    
+    brush=create_debrush_shared(win, sh);
+
     /* Set background colour */
     if(brush!=NULL && !slave){
         grbrush_enable_transparency(&(brush->grbrush), 
@@ -129,6 +261,15 @@ DEBrush *debrush_get_slave(DEBrush *master, WRootWin *rootwin,
 
 void debrush_deinit(DEBrush *brush)
 {
+    debatch_flush();
+    deshape_forget(brush->win);
+    debuffer_end(brush);
+#ifdef HAVE_X11_XFT
+    if(brush->draw!=NULL){
+        XftDrawDestroy(brush->draw);
+        brush->draw=NULL;
+    }
+#endif
     destyle_unref(brush->d);
     brush->d=NULL;
     gr_stylespec_unalloc(&brush->current_attr);
@@ -245,6 +386,20 @@ bool debrush_get_extra(DEBrush *brush, const char *key, char type, void *data)
 
 
 
+/*}}}*/
+
+
+/*{{{ Comparison */
+
+
+bool debrush_same_style(DEBrush *brush, GrBrush *other)
+{
+    DEBrush *o=OBJ_CAST(other, DEBrush);
+    
+    return (o!=NULL && o->d==brush->d && o->extras_fn==brush->extras_fn);
+}
+
+
 /*}}}*/
 
 
@@ -267,9 +422,11 @@ static DynFunTab debrush_dynfuntab[]={
     {grbrush_clear_area, debrush_clear_area},
     {grbrush_fill_area, debrush_fill_area},
     {(DynFun*)grbrush_get_extra, (DynFun*)debrush_get_extra},
+    {(DynFun*)grbrush_same_style, (DynFun*)debrush_same_style},
     {(DynFun*)grbrush_get_slave, (DynFun*)debrush_get_slave},
     {grbrush_begin, debrush_begin},
     {grbrush_end, debrush_end},
+    {(DynFun*)grbrush_end_pixmap, (DynFun*)debrush_end_pixmap},
     {grbrush_init_attr, debrush_init_attr},
     {grbrush_set_attr, debrush_set_attr},
     {grbrush_unset_attr, debrush_unset_attr},
@@ -19,6 +19,7 @@ INTRCLASS(DEBrush);
 
 #include "style.h"
 #include "colour.h"
+#include "buffer.h"
 
 
 typedef void DEBrushExtrasFn(DEBrush *brush, 
@@ -37,6 +38,11 @@ DECLCLASS(DEBrush){
     int indicator_w;
     Window win;
     bool clip_set;
+    XRectangle clip_rect;
+    DEBuffer *buffer;
+#ifdef HAVE_X11_XFT
+    XftDraw *draw;
+#endif
     
     GrStyleSpec current_attr;
 };
@@ -50,6 +56,10 @@ extern bool debrush_init(DEBrush *brush, Window win,
                          const GrStyleSpec *spec, DEStyle *style);
 extern void debrush_deinit(DEBrush *brush);
 
+extern void debrush_flush_shared();
+
+extern bool debrush_same_style(DEBrush *brush, GrBrush *other);
+
 extern DEBrush *debrush_get_slave(DEBrush *brush, WRootWin *rootwin, 
                                   const char *style);
 
@@ -69,6 +79,7 @@ extern DEColourGroup *debrush_get_current_colour_group(DEBrush *brush);
 
 extern void debrush_begin(DEBrush *brush, const WRectangle *geom, int flags);
 extern void debrush_end(DEBrush *brush);
+extern Pixmap debrush_end_pixmap(DEBrush *brush);
 
 extern void debrush_init_attr(DEBrush *brush, const GrStyleSpec *spec);
 extern void debrush_set_attr(DEBrush *brush, GrAttr attr);
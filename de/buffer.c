@@ -0,0 +1,328 @@
+/*
+ * ion/de/buffer.c
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#include <string.h>
+
+#include <libtu/misc.h>
+#include <libtu/dlist.h>
+#include <ioncore/common.h>
+#include <ioncore/global.h>
+#include <ioncore/rootwin.h>
+#include "buffer.h"
+#include "brush.h"
+#include "gc.h"
+#include "batch.h"
+
+
+/*{{{ Pixmap pool */
+
+
+/* Pixmaps are pooled by size, so that redrawing a window of unchanged
+ * size reuses the same pixmap. Released pixmaps are kept in order of
+ * release; the oldest one is freed when the pool is full.
+ */
+
+#define DE_BUFFER_POOL_SIZE 8
+
+
+typedef struct{
+    WRootWin *rootwin;
+    Pixmap pixmap;
+    GC gc;
+    int w, h;
+} DEBufferPixmap;
+
+
+static DEBufferPixmap pool[DE_BUFFER_POOL_SIZE];
+static int pool_n=0;
+
+
+static void free_pixmap(DEBufferPixmap *p)
+{
+    degc_free(p->gc);
+    XFreeGC(ioncore_g.dpy, p->gc);
+    XFreePixmap(ioncore_g.dpy, p->pixmap);
+}
+
+
+static bool get_pixmap(WRootWin *rootwin, int w, int h, DEBufferPixmap *ret)
+{
+    XGCValues gcv;
+    int i, best=-1;
+    
+    /* Take the smallest pooled pixmap that is large enough, so that 
+     * resizing does not always need a new pixmap.
+     */
+    for(i=0; i<pool_n; i++){
+        if(pool[i].rootwin!=rootwin || pool[i].w<w || pool[i].h<h)
+            continue;
+        if(best<0 || pool[i].w*pool[i].h<pool[best].w*pool[best].h)
+            best=i;
+    }
+    
+    if(best>=0){
+        *ret=pool[best];
+        pool_n--;
+        memmove(pool+best, pool+best+1, (pool_n-best)*sizeof(DEBufferPixmap));
+        return TRUE;
+    }
+    
+    ret->rootwin=rootwin;
+    ret->w=w;
+    ret->h=h;
+    ret->pixmap=XCreatePixmap(ioncore_g.dpy, WROOTWIN_ROOT(rootwin), w, h,
+                              DefaultDepth(ioncore_g.dpy, rootwin->xscr));
+    
+    if(ret->pixmap==None)
+        return FALSE;
+    
+    gcv.graphics_exposures=False;
+    ret->gc=XCreateGC(ioncore_g.dpy, ret->pixmap, GCGraphicsExposures, &gcv);
+    
+    return TRUE;
+}
+
+
+static void put_pixmap(const DEBufferPixmap *p)
+{
+    if(pool_n==DE_BUFFER_POOL_SIZE){
+        free_pixmap(pool);
+        pool_n--;
+        memmove(pool, pool+1, pool_n*sizeof(DEBufferPixmap));
+    }
+    
+    pool[pool_n++]=*p;
+}
+
+
+void debuffer_deinit()
+{
+    while(pool_n>0)
+        free_pixmap(&pool[--pool_n]);
+}
+
+
+/*}}}*/
+
+
+/*{{{ Active buffers */
+
+
+static DEBuffer *buffers=NULL;
+
+
+static DEBuffer *find_buffer(Window win)
+{
+    DEBuffer *buf;
+    
+    for(buf=buffers; buf!=NULL; buf=buf->next){
+        if(buf->win==win)
+            return buf;
+    }
+    
+    return NULL;
+}
+
+
+static bool rect_contains(const WRectangle *g, const WRectangle *g2)
+{
+    return (g2->x>=g->x && g2->y>=g->y &&
+            g2->x+g2->w<=g->x+g->w && g2->y+g2->h<=g->y+g->h);
+}
+
+
+static bool rect_overlaps(const WRectangle *g, const WRectangle *g2)
+{
+    return (g2->x<g->x+g->w && g->x<g2->x+g2->w &&
+            g2->y<g->y+g->h && g->y<g2->y+g2->h);
+}
+
+
+static void publish(DEBuffer *buf)
+{
+    XCopyArea(ioncore_g.dpy, buf->pixmap, buf->win, buf->gc,
+              0, 0, buf->geom.w, buf->geom.h, buf->geom.x, buf->geom.y);
+}
+
+
+/* Drawing by a brush of a window that already has an active buffer goes
+ * to that buffer even if the brush's own style does not ask for one, as
+ * it would otherwise be overwritten when the buffer is published.
+ * An offscreen buffer is set up regardless of the style, when possible,
+ * and always starts cleared.
+ */
+void debuffer_begin(DEBrush *brush, const WRectangle *geom, bool clear,
+                    bool offscreen)
+{
+    DEStyle *d=brush->d;
+    DEBufferPixmap p;
+    DEBuffer *buf;
+    
+    if(brush->buffer!=NULL || geom->w<=0 || geom->h<=0)
+        return;
+    
+    buf=find_buffer(brush->win);
+    
+    if(buf!=NULL){
+        if(!buf->passthrough && rect_contains(&buf->geom, geom)){
+            /* Nested drawing by e.g. a slave brush. */
+            buf->refcount++;
+            brush->buffer=buf;
+        }else if(!buf->passthrough && rect_overlaps(&buf->geom, geom)){
+            /* Can't combine the two; the outer drawing will continue
+             * directly on the window.
+             */
+            publish(buf);
+            buf->passthrough=TRUE;
+        }
+        return;
+    }
+    
+    /* Parent-relative backgrounds can't be reproduced on a pixmap. */
+    if((!d->back_buffer && !offscreen) 
+       || d->transparency_mode==GR_TRANSPARENCY_YES){
+        return;
+    }
+    
+    if(!get_pixmap(d->rootwin, geom->w, geom->h, &p))
+        return;
+    
+    buf=ALLOC(DEBuffer);
+    
+    if(buf==NULL){
+        put_pixmap(&p);
+        return;
+    }
+    
+    buf->win=brush->win;
+    buf->geom=*geom;
+    buf->bg=d->cgrp.bg;
+    buf->pixmap=p.pixmap;
+    buf->gc=p.gc;
+    buf->pixmap_w=p.w;
+    buf->pixmap_h=p.h;
+    buf->rootwin=p.rootwin;
+    buf->refcount=1;
+    buf->passthrough=FALSE;
+    buf->offscreen=offscreen;
+    
+    LINK_ITEM(buffers, buf, next, prev);
+    
+    brush->buffer=buf;
+    
+    if(offscreen){
+        degc_set_foreground(buf->gc, buf->bg);
+        XFillRectangle(ioncore_g.dpy, buf->pixmap, buf->gc,
+                       0, 0, geom->w, geom->h);
+    }else if(!clear){
+        /* Areas that are not drawn over must keep their current 
+         * contents. 
+         */
+        XCopyArea(ioncore_g.dpy, buf->win, buf->pixmap, buf->gc,
+                  geom->x, geom->y, geom->w, geom->h, 0, 0);
+    }
+}
+
+
+void debuffer_end(DEBrush *brush)
+{
+    DEBuffer *buf=brush->buffer;
+    DEBufferPixmap p;
+    
+    if(buf==NULL)
+        return;
+    
+    brush->buffer=NULL;
+    
+    if(--buf->refcount>0)
+        return;
+    
+    if(!buf->passthrough)
+        publish(buf);
+    
+    UNLINK_ITEM(buffers, buf, next, prev);
+    
+    p.rootwin=buf->rootwin;
+    p.pixmap=buf->pixmap;
+    p.gc=buf->gc;
+    p.w=buf->pixmap_w;
+    p.h=buf->pixmap_h;
+    
+    put_pixmap(&p);
+    
+    free(buf);
+}
+
+
+/* Returns the pixmap of an offscreen buffer, instead of publishing it,
+ * once the last brush drawing into it is done. 
+ */
+Pixmap debuffer_end_pixmap(DEBrush *brush)
+{
+    DEBuffer *buf=brush->buffer;
+    Pixmap pixmap;
+    
+    if(buf==NULL || !buf->offscreen || buf->passthrough 
+       || buf->refcount>1){
+        debuffer_end(brush);
+        return None;
+    }
+    
+    brush->buffer=NULL;
+    
+    UNLINK_ITEM(buffers, buf, next, prev);
+    
+    pixmap=buf->pixmap;
+    degc_free(buf->gc);
+    XFreeGC(ioncore_g.dpy, buf->gc);
+    
+    free(buf);
+    
+    return pixmap;
+}
+
+
+/*}}}*/
+
+
+/*{{{ Coordinates and clearing */
+
+
+void debrush_translate(DEBrush *brush, WRectangle *geom)
+{
+    debrush_translate_point(brush, &geom->x, &geom->y);
+}
+
+
+void debrush_translate_point(DEBrush *brush, int *x, int *y)
+{
+    if(DEBRUSH_BUFFERED(brush)){
+        *x-=brush->buffer->geom.x;
+        *y-=brush->buffer->geom.y;
+    }
+}
+
+
+/* The geometry is in drawable coordinates, i.e. already translated. */
+void debrush_do_clear_area(DEBrush *brush, const WRectangle *geom)
+{
+    debatch_flush();
+    
+    if(DEBRUSH_BUFFERED(brush)){
+        DEBuffer *buf=brush->buffer;
+        degc_set_foreground(buf->gc, buf->bg);
+        XFillRectangle(ioncore_g.dpy, buf->pixmap, buf->gc,
+                       geom->x, geom->y, geom->w, geom->h);
+    }else{
+        XClearArea(ioncore_g.dpy, brush->win,
+                   geom->x, geom->y, geom->w, geom->h, False);
+    }
+}
+
+
+/*}}}*/
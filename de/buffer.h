@@ -0,0 +1,61 @@
+/*
+ * ion/de/buffer.h
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#ifndef ION_DE_BUFFER_H
+#define ION_DE_BUFFER_H
+
+#include <ioncore/common.h>
+#include <ioncore/rectangle.h>
+
+INTRSTRUCT(DEBuffer);
+
+#include "brush.h"
+#include "colour.h"
+
+
+/* Back buffer for the area of a window being drawn between 
+ * debrush_begin and debrush_end. Master and slave brushes of the same
+ * window share the buffer when the areas they draw nest.
+ */
+DECLSTRUCT(DEBuffer){
+    Window win;
+    WRectangle geom;
+    DEColour bg;
+    
+    Pixmap pixmap;
+    GC gc;
+    int pixmap_w, pixmap_h;
+    WRootWin *rootwin;
+    
+    int refcount;
+    bool passthrough;
+    bool offscreen;
+    
+    DEBuffer *next, *prev;
+};
+
+
+#define DEBRUSH_BUFFERED(B) \
+    ((B)->buffer!=NULL && !(B)->buffer->passthrough)
+
+#define DEBRUSH_DRAWABLE(B) \
+    (DEBRUSH_BUFFERED(B) ? (Drawable)(B)->buffer->pixmap : (Drawable)(B)->win)
+
+extern void debuffer_begin(DEBrush *brush, const WRectangle *geom, 
+                           bool clear, bool offscreen);
+extern void debuffer_end(DEBrush *brush);
+extern Pixmap debuffer_end_pixmap(DEBrush *brush);
+
+extern void debrush_translate(DEBrush *brush, WRectangle *geom);
+extern void debrush_translate_point(DEBrush *brush, int *x, int *y);
+
+extern void debrush_do_clear_area(DEBrush *brush, const WRectangle *geom);
+
+extern void debuffer_deinit();
+
+#endif /* ION_DE_BUFFER_H */
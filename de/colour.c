@@ -66,3 +66,36 @@ void de_free_colour(WRootWin *rootwin, DEColour col)
     XFreeColors(ioncore_g.dpy, rootwin->default_cmap, pixels, 1, 0);
 }
 
+
+
+#ifdef HAVE_X11_XFT
+
+/* Text tends to be drawn in a handful of colours over and over again, 
+ * so remember the last conversion instead of asking the server each time.
+ */
+static WRootWin *xft_colour_rootwin=NULL;
+static DEColour xft_colour_pixel=0;
+static XRenderColor xft_colour_value;
+
+
+void de_get_xft_colour(WRootWin *rootwin, DEColour col, XftColor *ret)
+{
+    if(rootwin!=xft_colour_rootwin || col!=xft_colour_pixel){
+        XColor c;
+        
+        c.pixel=col;
+        XQueryColor(ioncore_g.dpy, rootwin->default_cmap, &c);
+        
+        xft_colour_value.red=c.red;
+        xft_colour_value.green=c.green;
+        xft_colour_value.blue=c.blue;
+        xft_colour_value.alpha=0xffff;
+        xft_colour_rootwin=rootwin;
+        xft_colour_pixel=col;
+    }
+    
+    ret->pixel=col;
+    ret->color=xft_colour_value;
+}
+
+#endif
@@ -13,6 +13,10 @@
 #include <ioncore/global.h>
 #include <ioncore/rootwin.h>
 
+#ifdef HAVE_X11_XFT
+#include <X11/Xft/Xft.h>
+#endif
+
 
 INTRSTRUCT(DEColourGroup);
 
@@ -35,4 +39,8 @@ bool de_duplicate_colour(WRootWin *rootwin, DEColour in, DEColour *out);
 void de_free_colour_group(WRootWin *rootwin, DEColourGroup *cg);
 void de_free_colour(WRootWin *rootwin, DEColour col);
 
+#ifdef HAVE_X11_XFT
+void de_get_xft_colour(WRootWin *rootwin, DEColour col, XftColor *ret);
+#endif
+
 #endif /* ION_DE_COLOUR_H */
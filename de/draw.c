@@ -16,8 +16,9 @@
 #include "brush.h"
 #include "font.h"
 #include "private.h"
-
-#include <X11/extensions/shape.h>
+#include "gc.h"
+#include "batch.h"
+#include "shape.h"
 
 
 /*{{{ Colour group lookup */
@@ -29,6 +30,11 @@ static DEColourGroup *destyle_get_colour_group2(DEStyle *style,
 {
     int i, score, maxscore=0;
     DEColourGroup *maxg=&(style->cgrp);
+    DEStyle *first=style;
+    void *cached;
+    
+    if(deattrcache_lookup(&first->cgrp_cache, NULL, a1, a2, &cached))
+        return (DEColourGroup*)cached;
     
     while(style!=NULL){
         for(i=0; i<style->n_extra_cgrps; i++){
@@ -42,6 +48,8 @@ static DEColourGroup *destyle_get_colour_group2(DEStyle *style,
         style=style->based_on;
     }
     
+    deattrcache_store(&first->cgrp_cache, NULL, a1, a2, maxg);
+    
     return maxg;
 }
 
@@ -74,57 +82,46 @@ DEColourGroup *debrush_get_current_colour_group(DEBrush *brush)
 
 /* Draw a border at x, y with outer width w x h. Top and left 'tl' pixels
  * wide with color 'tlc' and bottom and right 'br' pixels with colors 'brc'.
+ * Each line is queued as two rectangles covering the same pixels as the
+ * corresponding butt-capped polyline would.
  */
-static void do_draw_border(Window win, GC gc, int x, int y, int w, int h,
+static void do_draw_border(Drawable win, GC gc, int x, int y, int w, int h,
                            uint tl, uint br, DEColour tlc, DEColour brc)
 {
-    XPoint points[3];
     uint i=0, a=0, b=0;
     
     w--;
     h--;
 
-    XSetForeground(ioncore_g.dpy, gc, tlc);
-
-    
     a=(br!=0);
     b=0;
     
     for(i=0; i<tl; i++){
-        points[0].x=x+i;        points[0].y=y+h+1-b;
-        points[1].x=x+i;        points[1].y=y+i;
-        points[2].x=x+w+1-a;    points[2].y=y+i;
+        debatch_fill_rect(win, gc, tlc, x+i, y+i, 1, h+1-b-i);
+        debatch_fill_rect(win, gc, tlc, x+i, y+i, w+1-a-i, 1);
 
         if(a<br)
             a++;
         if(b<br)
             b++;
-    
-        XDrawLines(ioncore_g.dpy, win, gc, points, 3, CoordModeOrigin);
     }
 
-    
-    XSetForeground(ioncore_g.dpy, gc, brc);
-
     a=(tl!=0);
     b=0;
     
     for(i=0; i<br; i++){
-        points[0].x=x+w-i;      points[0].y=y+b;
-        points[1].x=x+w-i;      points[1].y=y+h-i;
-        points[2].x=x+a;        points[2].y=y+h-i;
+        debatch_fill_rect(win, gc, brc, x+w-i, y+b, 1, h-i-b+1);
+        debatch_fill_rect(win, gc, brc, x+a, y+h-i, w-i-a, 1);
     
         if(a<tl)
             a++;
         if(b<tl)
             b++;
-        
-        XDrawLines(ioncore_g.dpy, win, gc, points, 3, CoordModeOrigin);
     }
 }
 
 
-static void draw_border(Window win, GC gc, WRectangle *geom,
+static void draw_border(Drawable win, GC gc, WRectangle *geom,
                         uint tl, uint br, DEColour tlc, DEColour brc)
 {
     do_draw_border(win, gc, geom->x, geom->y, geom->w, geom->h,
@@ -136,29 +133,23 @@ static void draw_border(Window win, GC gc, WRectangle *geom,
 }
 
 
-static void draw_borderline(Window win, GC gc, WRectangle *geom,
+static void draw_borderline(Drawable win, GC gc, WRectangle *geom,
                             uint tl, uint br, DEColour tlc, DEColour brc, 
                             GrBorderLine line)
 {
     if(line==GR_BORDERLINE_LEFT && geom->h>0 && tl>0){
-        XSetForeground(ioncore_g.dpy, gc, tlc);
-        XSetBackground(ioncore_g.dpy, gc, tlc);
-        XFillRectangle(ioncore_g.dpy, win, gc, geom->x, geom->y, tl, geom->h);
+        debatch_fill_rect(win, gc, tlc, geom->x, geom->y, tl, geom->h);
         geom->x+=tl;
     }else if(line==GR_BORDERLINE_TOP && geom->w>0 && tl>0){
-        XSetForeground(ioncore_g.dpy, gc, tlc);
-        XSetBackground(ioncore_g.dpy, gc, tlc);
-        XFillRectangle(ioncore_g.dpy, win, gc, geom->x, geom->y, geom->w, tl);
+        debatch_fill_rect(win, gc, tlc, geom->x, geom->y, geom->w, tl);
         geom->y+=tl;
     }else if(line==GR_BORDERLINE_RIGHT && geom->h>0 && br>0){
-        XSetForeground(ioncore_g.dpy, gc, brc);
-        XSetBackground(ioncore_g.dpy, gc, brc);
-        XFillRectangle(ioncore_g.dpy, win, gc, geom->x+geom->w-br, geom->y, br, geom->h);
+        debatch_fill_rect(win, gc, brc, geom->x+geom->w-br, geom->y, 
+                          br, geom->h);
         geom->w-=br;
     }else if(line==GR_BORDERLINE_BOTTOM && geom->w>0 && br>0){
-        XSetForeground(ioncore_g.dpy, gc, brc);
-        XSetBackground(ioncore_g.dpy, gc, brc);
-        XFillRectangle(ioncore_g.dpy, win, gc, geom->x, geom->y+geom->h-br, geom->w, br);
+        debatch_fill_rect(win, gc, brc, geom->x, geom->y+geom->h-br, 
+                          geom->w, br);
         geom->h-=br;
     }
 }
@@ -169,7 +160,7 @@ void debrush_do_draw_borderline(DEBrush *brush, WRectangle geom,
 {
     DEBorder *bd=&(brush->d->border);
     GC gc=brush->d->normal_gc;
-    Window win=brush->win;
+    Drawable win=DEBRUSH_DRAWABLE(brush);
     
     switch(bd->style){
     case DEBORDER_RIDGE:
@@ -197,7 +188,7 @@ void debrush_do_draw_padline(DEBrush *brush, WRectangle geom,
 {
     DEBorder *bd=&(brush->d->border);
     GC gc=brush->d->normal_gc;
-    Window win=brush->win;
+    Drawable win=DEBRUSH_DRAWABLE(brush);
     
     draw_borderline(win, gc, &geom, bd->pad, bd->pad, cg->pad, cg->pad, line);
 }
@@ -207,8 +198,12 @@ void debrush_draw_borderline(DEBrush *brush, const WRectangle *geom,
                              GrBorderLine line)
 {
     DEColourGroup *cg=debrush_get_current_colour_group(brush);
+    WRectangle g=*geom;
+    
+    debrush_translate(brush, &g);
+    
     if(cg!=NULL)
-        debrush_do_draw_borderline(brush, *geom, cg, line);
+        debrush_do_draw_borderline(brush, g, cg, line);
 }
 
 
@@ -217,7 +212,7 @@ static void debrush_do_do_draw_border(DEBrush *brush, WRectangle geom,
 {
     DEBorder *bd=&(brush->d->border);
     GC gc=brush->d->normal_gc;
-    Window win=brush->win;
+    Drawable win=DEBRUSH_DRAWABLE(brush);
     
     switch(bd->style){
     case DEBORDER_RIDGE:
@@ -269,8 +264,12 @@ void debrush_draw_border(DEBrush *brush,
                          const WRectangle *geom)
 {
     DEColourGroup *cg=debrush_get_current_colour_group(brush);
+    WRectangle g=*geom;
+    
+    debrush_translate(brush, &g);
+    
     if(cg!=NULL)
-        debrush_do_draw_border(brush, *geom, cg);
+        debrush_do_draw_border(brush, g, cg);
 }
 
 
@@ -287,8 +286,8 @@ static void copy_masked(DEBrush *brush, Drawable src, Drawable dst,
     
     GC copy_gc=brush->d->copy_gc;
     
-    XSetClipMask(ioncore_g.dpy, copy_gc, src);
-    XSetClipOrigin(ioncore_g.dpy, copy_gc, dst_x, dst_y);
+    debatch_flush();
+    degc_set_clip_mask(copy_gc, src, dst_x, dst_y);
     XCopyPlane(ioncore_g.dpy, src, dst, copy_gc, src_x, src_y, w, h,
                dst_x, dst_y, 1);
 }
@@ -343,11 +342,14 @@ void debrush_tab_extras(DEBrush *brush, const WRectangle *g,
     
     if(pre){
         if(ISSET(a2, GR_ATTR(dragged)) || ISSET(a1, GR_ATTR(dragged))){
+            /* Queued strings are drawn with whatever normal_gc is
+             * when flushed. */
+            debatch_flush();
             tmp=d->normal_gc;
             d->normal_gc=d->stipple_gc;
             d->stipple_gc=tmp;
             swapped=TRUE;
-            XClearArea(ioncore_g.dpy, brush->win, g->x, g->y, g->w, g->h, False);
+            debrush_do_clear_area(brush, g);
         }
         return;
     }
@@ -388,15 +390,16 @@ void debrush_tab_extras(DEBrush *brush, const WRectangle *g,
     }
     
     if(ISSET(a2, GR_ATTR(tagged)) || ISSET(a1, GR_ATTR(tagged))){
-        XSetForeground(ioncore_g.dpy, d->copy_gc, cg->fg);
+        degc_set_foreground(d->copy_gc, cg->fg);
             
-        copy_masked(brush, d->tag_pixmap, brush->win, 0, 0,
+        copy_masked(brush, d->tag_pixmap, DEBRUSH_DRAWABLE(brush), 0, 0,
                     d->tag_pixmap_w, d->tag_pixmap_h,
                     g->x+g->w-bdw->right-d->tag_pixmap_w, 
                     g->y+bdw->top);
     }
     
     if(swapped){
+        debatch_flush();
         tmp=d->normal_gc;
         d->normal_gc=d->stipple_gc;
         d->stipple_gc=tmp;
@@ -441,9 +444,8 @@ void debrush_do_draw_box(DEBrush *brush, const WRectangle *geom,
     GC gc=brush->d->normal_gc;
     
     if(TRUE/*needfill*/){
-        XSetForeground(ioncore_g.dpy, gc, cg->bg);
-        XFillRectangle(ioncore_g.dpy, brush->win, gc, geom->x, geom->y, 
-                       geom->w, geom->h);
+        debatch_fill_rect(DEBRUSH_DRAWABLE(brush), gc, cg->bg,
+                          geom->x, geom->y, geom->w, geom->h);
     }
     
     debrush_do_draw_border(brush, *geom, cg);
@@ -507,14 +509,30 @@ void debrush_draw_textbox(DEBrush *brush, const WRectangle *geom,
 {
     GrStyleSpec *attr=debrush_get_current_attr(brush);
     DEColourGroup *cg=debrush_get_colour_group(brush, attr);
+    WRectangle g=*geom;
+    
+    debrush_translate(brush, &g);
     
     if(cg!=NULL){
-        debrush_do_draw_textbox(brush, geom, text, cg, needfill, 
+        debrush_do_draw_textbox(brush, &g, text, cg, needfill, 
                                 attr, NULL, -1);
     }
 }
 
 
+/* g is in drawable coordinates. */
+static bool debrush_clipped_out(DEBrush *brush, const WRectangle *g)
+{
+    const XRectangle *c=&brush->clip_rect;
+    
+    if(!brush->clip_set)
+        return FALSE;
+    
+    return (g->x>=c->x+(int)c->width || g->x+g->w<=c->x ||
+            g->y>=c->y+(int)c->height || g->y+g->h<=c->y);
+}
+
+
 void debrush_draw_textboxes(DEBrush *brush, const WRectangle *geom,
                             int n, const GrTextElem *elem, 
                             bool needfill)
@@ -529,9 +547,18 @@ void debrush_draw_textboxes(DEBrush *brush, const WRectangle *geom,
     
     grbrush_get_border_widths(&(brush->grbrush), &bdw);
     
+    debrush_translate(brush, &g);
+    
     for(i=0; ; i++){
         g.w=bdw.left+elem[i].iw+bdw.right;
-        cg=debrush_get_colour_group2(brush, common_attrib, &elem[i].attr);
+        
+        if(!debrush_clipped_out(brush, &g)){
+            cg=debrush_get_colour_group2(brush, common_attrib, 
+                                         &elem[i].attr);
+        }else{
+            /* Entirely outside the clipping rectangle. */
+            cg=NULL;
+        }
         
         if(cg!=NULL){
             debrush_do_draw_textbox(brush, &g, elem[i].text, cg, needfill,
@@ -543,8 +570,9 @@ void debrush_draw_textboxes(DEBrush *brush, const WRectangle *geom,
         
         g.x+=g.w;
         if(bdw.spacing>0 && needfill){
-            XClearArea(ioncore_g.dpy, brush->win, g.x, g.y,
-                       brush->d->spacing, g.h, False);
+            WRectangle sg=g;
+            sg.w=brush->d->spacing;
+            debrush_do_clear_area(brush, &sg);
         }
         g.x+=bdw.spacing;
     }
@@ -556,16 +584,14 @@ void debrush_draw_textboxes(DEBrush *brush, const WRectangle *geom,
 
 /*{{{ Misc. */
 
-#define MAXSHAPE 16
-
 void debrush_set_window_shape(DEBrush *brush, bool rough,
                               int n, const WRectangle *rects)
 {
-    XRectangle r[MAXSHAPE];
+    XRectangle r[DESHAPE_MAX];
     int i;
     
-    if(n>MAXSHAPE)
-        n=MAXSHAPE;
+    if(n>DESHAPE_MAX)
+        n=DESHAPE_MAX;
     
     if(n==0){
 	/* n==0 should clear the shape. As there's absolutely no
@@ -587,9 +613,7 @@ void debrush_set_window_shape(DEBrush *brush, bool rough,
 	}
     }
     
-    XShapeCombineRectangles(ioncore_g.dpy, brush->win,
-                            ShapeBounding, 0, 0, r, n,
-                            ShapeSet, Unsorted);
+    deshape_set(brush->win, n, r);
 }
 
 
@@ -609,6 +633,7 @@ void debrush_enable_transparency(DEBrush *brush, GrTransparency mode)
         attr.background_pixel=brush->d->cgrp.bg;
     }
     
+    debatch_flush();
     XChangeWindowAttributes(ioncore_g.dpy, brush->win, attrflags, &attr);
     XClearWindow(ioncore_g.dpy, brush->win);
 }
@@ -618,20 +643,24 @@ void debrush_fill_area(DEBrush *brush, const WRectangle *geom)
 {
     DEColourGroup *cg=debrush_get_current_colour_group(brush);
     GC gc=brush->d->normal_gc;
+    WRectangle g=*geom;
 
     if(cg==NULL)
         return;
     
-    XSetForeground(ioncore_g.dpy, gc, cg->bg);
-    XFillRectangle(ioncore_g.dpy, brush->win, gc, 
-                   geom->x, geom->y, geom->w, geom->h);
+    debrush_translate(brush, &g);
+    
+    debatch_fill_rect(DEBRUSH_DRAWABLE(brush), gc, cg->bg,
+                      g.x, g.y, g.w, g.h);
 }
 
 
 void debrush_clear_area(DEBrush *brush, const WRectangle *geom)
 {
-    XClearArea(ioncore_g.dpy, brush->win,
-               geom->x, geom->y, geom->w, geom->h, False);
+    WRectangle g=*geom;
+    
+    debrush_translate(brush, &g);
+    debrush_do_clear_area(brush, &g);
 }
 
 
@@ -649,15 +678,20 @@ static void debrush_set_clipping_rectangle(DEBrush *brush,
 {
     XRectangle rect;
     
+    int x=geom->x, y=geom->y;
+    
     assert(!brush->clip_set);
     
-    rect.x=geom->x;
-    rect.y=geom->y;
+    debatch_flush();
+    debrush_translate_point(brush, &x, &y);
+    
+    rect.x=x;
+    rect.y=y;
     rect.width=geom->w;
     rect.height=geom->h;
     
-    XSetClipRectangles(ioncore_g.dpy, brush->d->normal_gc,
-                       0, 0, &rect, 1, Unsorted);
+    degc_set_clip_rectangle(brush->d->normal_gc, &rect);
+    brush->clip_rect=rect;
     brush->clip_set=TRUE;
 }
 
@@ -665,7 +699,8 @@ static void debrush_set_clipping_rectangle(DEBrush *brush,
 static void debrush_clear_clipping_rectangle(DEBrush *brush)
 {
     if(brush->clip_set){
-        XSetClipMask(ioncore_g.dpy, brush->d->normal_gc, None);
+        debatch_flush();
+        degc_clear_clip(brush->d->normal_gc);
         brush->clip_set=FALSE;
     }
 }
@@ -686,6 +721,12 @@ void debrush_begin(DEBrush *brush, const WRectangle *geom, int flags)
     if(!(flags&GRBRUSH_KEEP_ATTR))
         debrush_init_attr(brush, NULL);
     
+    debatch_flush();
+    debatch_begin();
+    
+    debuffer_begin(brush, geom, !(flags&GRBRUSH_NO_CLEAR_OK),
+                   flags&GRBRUSH_OFFSCREEN);
+    
     if(!(flags&GRBRUSH_NO_CLEAR_OK))
         debrush_clear_area(brush, geom);
     
@@ -696,7 +737,17 @@ void debrush_begin(DEBrush *brush, const WRectangle *geom, int flags)
 
 void debrush_end(DEBrush *brush)
 {
+    debatch_end();
+    debrush_clear_clipping_rectangle(brush);
+    debuffer_end(brush);
+}
+
+
+Pixmap debrush_end_pixmap(DEBrush *brush)
+{
+    debatch_end();
     debrush_clear_clipping_rectangle(brush);
+    return debuffer_end_pixmap(brush);
 }
 
 
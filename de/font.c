@@ -13,6 +13,8 @@
 #include "font.h"
 #include "fontset.h"
 #include "brush.h"
+#include "gc.h"
+#include "batch.h"
 
 
 /*{{{ Load/free */
@@ -21,22 +23,32 @@
 static DEFont *fonts=NULL;
 
 
-DEFont *de_load_font(const char *fontname)
+DEFont *de_load_font(const char *fontname, int xscr)
 {
     DEFont *fnt;
     XFontSet fontset=NULL;
     XFontStruct *fontstruct=NULL;
+#ifdef HAVE_X11_XFT
+    XftFont *font=NULL;
+#endif
     
     assert(fontname!=NULL);
     
     /* There shouldn't be that many fonts... */
     for(fnt=fonts; fnt!=NULL; fnt=fnt->next){
-        if(strcmp(fnt->pattern, fontname)==0){
+        if(strcmp(fnt->pattern, fontname)==0 &&
+           (fnt->xscr<0 || fnt->xscr==xscr)){
             fnt->refcount++;
             return fnt;
         }
     }
     
+#ifdef HAVE_X11_XFT
+    if(strncmp(fontname, DE_XFT_PREFIX, DE_XFT_PREFIX_LEN)==0){
+        font=XftFontOpenName(ioncore_g.dpy, xscr, 
+                             fontname+DE_XFT_PREFIX_LEN);
+    }else
+#endif
     if(ioncore_g.use_mb){
         fontset=de_create_font_set(fontname);
         if(fontset!=NULL){
@@ -50,12 +62,16 @@ DEFont *de_load_font(const char *fontname)
         fontstruct=XLoadQueryFont(ioncore_g.dpy, fontname);
     }
     
-    if(fontstruct==NULL && fontset==NULL){
+    if(fontstruct==NULL && fontset==NULL
+#ifdef HAVE_X11_XFT
+       && font==NULL
+#endif
+       ){
         if(strcmp(fontname, CF_FALLBACK_FONT_NAME)!=0){
             DEFont *fnt;
             warn(TR("Could not load font \"%s\", trying \"%s\""),
                  fontname, CF_FALLBACK_FONT_NAME);
-            fnt=de_load_font(CF_FALLBACK_FONT_NAME);
+            fnt=de_load_font(CF_FALLBACK_FONT_NAME, xscr);
             if(fnt==NULL)
                 warn(TR("Failed to load fallback font."));
             return fnt;
@@ -70,11 +86,19 @@ DEFont *de_load_font(const char *fontname)
     
     fnt->fontset=fontset;
     fnt->fontstruct=fontstruct;
+    fnt->xscr=-1;
+#ifdef HAVE_X11_XFT
+    fnt->font=font;
+    if(font!=NULL)
+        fnt->xscr=xscr;
+#endif
     fnt->pattern=scopy(fontname);
     fnt->next=NULL;
     fnt->prev=NULL;
     fnt->refcount=1;
     
+    defont_init_advances(fnt);
+    
     LINK_ITEM(fonts, fnt, next, prev);
     
     return fnt;
@@ -90,8 +114,7 @@ bool de_set_font_for_style(DEStyle *style, DEFont *font)
     font->refcount++;
     
     if(style->font->fontstruct!=NULL){
-        XSetFont(ioncore_g.dpy, style->normal_gc, 
-                 style->font->fontstruct->fid);
+        degc_set_font(style->normal_gc, style->font->fontstruct->fid);
     }
 
     return TRUE;
@@ -103,14 +126,13 @@ bool de_load_font_for_style(DEStyle *style, const char *fontname)
     if(style->font!=NULL)
         de_free_font(style->font);
     
-    style->font=de_load_font(fontname);
+    style->font=de_load_font(fontname, style->rootwin->xscr);
 
     if(style->font==NULL)
         return FALSE;
     
     if(style->font->fontstruct!=NULL){
-        XSetFont(ioncore_g.dpy, style->normal_gc, 
-                 style->font->fontstruct->fid);
+        degc_set_font(style->normal_gc, style->font->fontstruct->fid);
     }
     
     return TRUE;
@@ -122,10 +144,16 @@ void de_free_font(DEFont *font)
     if(--font->refcount!=0)
         return;
     
+    defont_deinit_advances(font);
+    
     if(font->fontset!=NULL)
         XFreeFontSet(ioncore_g.dpy, font->fontset);
     if(font->fontstruct!=NULL)
         XFreeFont(ioncore_g.dpy, font->fontstruct);
+#ifdef HAVE_X11_XFT
+    if(font->font!=NULL)
+        XftFontClose(ioncore_g.dpy, font->font);
+#endif
     if(font->pattern!=NULL)
         free(font->pattern);
     
@@ -153,6 +181,14 @@ void debrush_get_font_extents(DEBrush *brush, GrFontExtents *fnte)
 
 void defont_get_font_extents(DEFont *font, GrFontExtents *fnte)
 {
+#ifdef HAVE_X11_XFT
+    if(font->font!=NULL){
+        fnte->max_height=font->font->ascent+font->font->descent;
+        fnte->max_width=font->font->max_advance_width;
+        fnte->baseline=font->font->ascent;
+        return;
+    }
+#endif
     if(font->fontset!=NULL){
         XFontSetExtents *ext=XExtentsOfFontSet(font->fontset);
         if(ext==NULL)
@@ -183,8 +219,22 @@ uint debrush_get_text_width(DEBrush *brush, const char *text, uint len)
 }
 
 
-uint defont_get_text_width(DEFont *font, const char *text, uint len)
+static uint defont_do_get_text_width(DEFont *font, const char *text, 
+                                     uint len)
 {
+#ifdef HAVE_X11_XFT
+    if(font->font!=NULL){
+        XGlyphInfo extents;
+        if(ioncore_g.enc_utf8){
+            XftTextExtentsUtf8(ioncore_g.dpy, font->font, 
+                               (const FcChar8*)text, len, &extents);
+        }else{
+            XftTextExtents8(ioncore_g.dpy, font->font, 
+                            (const FcChar8*)text, len, &extents);
+        }
+        return extents.xOff;
+    }
+#endif
     if(font->fontset!=NULL){
         XRectangle lext;
 #ifdef CF_DE_USE_XUTF8
@@ -202,53 +252,140 @@ uint defont_get_text_width(DEFont *font, const char *text, uint len)
 }
 
 
+uint defont_get_text_width(DEFont *font, const char *text, uint len)
+{
+    uint w;
+    
+    if(defont_lookup_text_width(font, text, len, &w))
+        return w;
+    
+    w=defont_do_get_text_width(font, text, len);
+    
+    defont_store_text_width(font, text, len, w);
+    
+    return w;
+}
+
+
 /*}}}*/
 
 
 /*{{{ String drawing */
 
 
+#ifdef HAVE_X11_XFT
+
+static XftDraw *debrush_get_draw(DEBrush *brush, Drawable d)
+{
+    WRootWin *rootwin=brush->d->rootwin;
+    
+    if(brush->draw==NULL){
+        brush->draw=XftDrawCreate(ioncore_g.dpy, d,
+                                  DefaultVisual(ioncore_g.dpy, rootwin->xscr),
+                                  rootwin->default_cmap);
+    }else if(XftDrawDrawable(brush->draw)!=d){
+        XftDrawChange(brush->draw, d);
+    }
+    
+    return brush->draw;
+}
+
+
+static void debrush_do_draw_string_xft(DEBrush *brush, int x, int y,
+                                       const char *str, int len, 
+                                       bool needfill, 
+                                       DEColourGroup *colours)
+{
+    Drawable win=DEBRUSH_DRAWABLE(brush);
+    XftFont *font=brush->d->font->font;
+    XftDraw *draw=debrush_get_draw(brush, win);
+    XftColor xc;
+    
+    if(draw==NULL)
+        return;
+    
+    if(brush->clip_set)
+        XftDrawSetClipRectangles(draw, 0, 0, &brush->clip_rect, 1);
+    else
+        XftDrawSetClip(draw, None);
+    
+    if(needfill){
+        GC gc=brush->d->normal_gc;
+        XGlyphInfo extents;
+        
+        if(ioncore_g.enc_utf8){
+            XftTextExtentsUtf8(ioncore_g.dpy, font, (const FcChar8*)str, 
+                               len, &extents);
+        }else{
+            XftTextExtents8(ioncore_g.dpy, font, (const FcChar8*)str, 
+                            len, &extents);
+        }
+        
+        degc_set_foreground(gc, colours->bg);
+        XFillRectangle(ioncore_g.dpy, win, gc, x, y-font->ascent,
+                       extents.xOff, font->ascent+font->descent);
+    }
+    
+    de_get_xft_colour(brush->d->rootwin, colours->fg, &xc);
+    
+    if(ioncore_g.enc_utf8)
+        XftDrawStringUtf8(draw, &xc, font, x, y, (const FcChar8*)str, len);
+    else
+        XftDrawString8(draw, &xc, font, x, y, (const FcChar8*)str, len);
+}
+
+#endif
+
+
 void debrush_do_draw_string_default(DEBrush *brush, int x, int y,
                                     const char *str, int len, bool needfill, 
                                     DEColourGroup *colours)
 {
     GC gc=brush->d->normal_gc;
+    Drawable win=DEBRUSH_DRAWABLE(brush);
 
     if(brush->d->font==NULL)
         return;
     
-    XSetForeground(ioncore_g.dpy, gc, colours->fg);
+#ifdef HAVE_X11_XFT
+    if(brush->d->font->font!=NULL){
+        debrush_do_draw_string_xft(brush, x, y, str, len, needfill, colours);
+        return;
+    }
+#endif
+    
+    degc_set_foreground(gc, colours->fg);
     
     if(!needfill){
         if(brush->d->font->fontset!=NULL){
 #ifdef CF_DE_USE_XUTF8
             if(ioncore_g.enc_utf8)
-                Xutf8DrawString(ioncore_g.dpy, brush->win, 
+                Xutf8DrawString(ioncore_g.dpy, win, 
                                 brush->d->font->fontset,
                                 gc, x, y, str, len);
             else
 #endif
-                XmbDrawString(ioncore_g.dpy, brush->win, 
+                XmbDrawString(ioncore_g.dpy, win, 
                               brush->d->font->fontset,
                               gc, x, y, str, len);
         }else if(brush->d->font->fontstruct!=NULL){
-            XDrawString(ioncore_g.dpy, brush->win, gc, x, y, str, len);
+            XDrawString(ioncore_g.dpy, win, gc, x, y, str, len);
         }
     }else{
-        XSetBackground(ioncore_g.dpy, gc, colours->bg);
+        degc_set_background(gc, colours->bg);
         if(brush->d->font->fontset!=NULL){
 #ifdef CF_DE_USE_XUTF8
             if(ioncore_g.enc_utf8)
-                Xutf8DrawImageString(ioncore_g.dpy, brush->win, 
+                Xutf8DrawImageString(ioncore_g.dpy, win, 
                                      brush->d->font->fontset,
                                      gc, x, y, str, len);
             else
 #endif
-                XmbDrawImageString(ioncore_g.dpy, brush->win, 
+                XmbDrawImageString(ioncore_g.dpy, win, 
                                    brush->d->font->fontset,
                                    gc, x, y, str, len);
         }else if(brush->d->font->fontstruct!=NULL){
-            XDrawImageString(ioncore_g.dpy, brush->win, gc, x, y, str, len);
+            XDrawImageString(ioncore_g.dpy, win, gc, x, y, str, len);
         }
     }
 }
@@ -258,6 +395,9 @@ void debrush_do_draw_string(DEBrush *brush, int x, int y,
                             const char *str, int len, bool needfill, 
                             DEColourGroup *colours)
 {
+    if(debatch_draw_string(brush, x, y, str, len, needfill, colours))
+        return;
+    
     CALL_DYN(debrush_do_draw_string, brush, (brush, x, y, str, len,
                                              needfill, colours));
 }
@@ -267,6 +407,9 @@ void debrush_draw_string(DEBrush *brush, int x, int y,
                          const char *str, int len, bool needfill)
 {
     DEColourGroup *cg=debrush_get_current_colour_group(brush);
+    
+    debrush_translate_point(brush, &x, &y);
+    
     if(cg!=NULL)
         debrush_do_draw_string(brush, x, y, str, len, needfill, cg);
 }
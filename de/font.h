@@ -12,26 +12,43 @@
 #include <ioncore/common.h>
 #include <ioncore/gr.h>
 
+#ifdef HAVE_X11_XFT
+#include <X11/Xft/Xft.h>
+#endif
+
 INTRSTRUCT(DEFont);
 
 #include "brush.h"
 #include "colour.h"
 #include "style.h"
+#include "fontcache.h"
+
+/* Patterns with this prefix are loaded through Xft. */
+#define DE_XFT_PREFIX "xft:"
+#define DE_XFT_PREFIX_LEN 4
 
 #define DE_RESET_FONT_EXTENTS(FNTE) \
    {(FNTE)->max_height=0; (FNTE)->max_width=0; (FNTE)->baseline=0;}
 
 DECLSTRUCT(DEFont){
     char *pattern;
+    /* Xft fonts are matched for a screen; -1 for core fonts. */
+    int xscr;
     int refcount;
     XFontSet fontset;
     XFontStruct *fontstruct;
+#ifdef HAVE_X11_XFT
+    XftFont *font;
+#endif
+    DEWidthCache *widths;
+    ushort *advances;
+    int fixed_advance;
     DEFont *next, *prev;
 };
 
 extern bool de_load_font_for_style(DEStyle *style, const char *fontname);
 extern bool de_set_font_for_style(DEStyle *style, DEFont *font);
-extern DEFont *de_load_font(const char *fontname);
+extern DEFont *de_load_font(const char *fontname, int xscr);
 extern void de_free_font(DEFont *font);
 
 extern void debrush_draw_string(DEBrush *brush, int x, int y,
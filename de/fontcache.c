@@ -0,0 +1,324 @@
+/*
+ * ion/de/fontcache.c
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#ifdef CF_NO_LOCALE
+#include <ioncore/dummywc.h>
+#else
+#include <wchar.h>
+#endif
+
+#include <libtu/misc.h>
+#include <libtu/dlist.h>
+#include <ioncore/common.h>
+#include <ioncore/global.h>
+#include "font.h"
+#include "fontcache.h"
+
+
+/*{{{ Advance tables */
+
+
+static bool fontset_fixed_advance(XFontSet fontset, int *ret)
+{
+    XFontStruct **fontstructs;
+    char **fontnames;
+    int i, n, w=-1;
+    
+    n=XFontsOfFontSet(fontset, &fontstructs, &fontnames);
+    
+    for(i=0; i<n; i++){
+        XFontStruct *fs=fontstructs[i];
+        if(fs->min_bounds.width!=fs->max_bounds.width)
+            return FALSE;
+        if(w>=0 && fs->max_bounds.width!=w)
+            return FALSE;
+        w=fs->max_bounds.width;
+    }
+    
+    if(w<=0)
+        return FALSE;
+    
+    *ret=w;
+    return TRUE;
+}
+
+
+void defont_init_advances(DEFont *font)
+{
+    int i;
+    
+    font->widths=NULL;
+    font->advances=NULL;
+    font->fixed_advance=0;
+    
+    if(font->fontset!=NULL){
+        int w;
+        if(fontset_fixed_advance(font->fontset, &w))
+            font->fixed_advance=w;
+        return;
+    }
+    
+    if(font->fontstruct!=NULL){
+        /* XTextWidth is the sum of the per-character widths, so the 
+         * table can be filled up front.
+         */
+        font->advances=ALLOC_N(ushort, DE_ADVANCE_TABLE_SIZE);
+        if(font->advances!=NULL){
+            for(i=0; i<DE_ADVANCE_TABLE_SIZE; i++){
+                char c=(char)i;
+                font->advances[i]=XTextWidth(font->fontstruct, &c, 1);
+            }
+        }
+        return;
+    }
+    
+#ifdef HAVE_X11_XFT
+    if(font->font!=NULL){
+        /* Filled lazily as code points are seen. */
+        font->advances=ALLOC_N(ushort, DE_ADVANCE_TABLE_SIZE);
+        if(font->advances!=NULL){
+            for(i=0; i<DE_ADVANCE_TABLE_SIZE; i++)
+                font->advances[i]=DE_ADVANCE_UNKNOWN;
+        }
+    }
+#endif
+}
+
+
+static int count_chars(const char *text, uint len)
+{
+    int n=0;
+    
+    if(ioncore_g.enc_sb)
+        return len;
+    
+    if(ioncore_g.enc_utf8){
+        uint i;
+        for(i=0; i<len; i++){
+            if((text[i]&0xC0)!=0x80)
+                n++;
+        }
+        return n;
+    }
+    
+    {
+        mbstate_t ps;
+        int l;
+        
+        memset(&ps, 0, sizeof(ps));
+        
+        while(len>0){
+            l=mbrlen(text, len, &ps);
+            if(l<=0)
+                return -1;
+            text+=l;
+            len-=l;
+            n++;
+        }
+        return n;
+    }
+}
+
+
+static ushort get_advance(DEFont *font, uint cp)
+{
+    ushort adv=font->advances[cp];
+    
+#ifdef HAVE_X11_XFT
+    if(adv==DE_ADVANCE_UNKNOWN && font->font!=NULL){
+        XGlyphInfo extents;
+        FcChar32 c=cp;
+        XftTextExtents32(ioncore_g.dpy, font->font, &c, 1, &extents);
+        adv=(extents.xOff>0 ? extents.xOff : 0);
+        font->advances[cp]=adv;
+    }
+#endif
+    
+    return adv;
+}
+
+
+static bool sum_advances(DEFont *font, const char *text, uint len, uint *ret)
+{
+    const unsigned char *p=(const unsigned char*)text;
+    uint i=0, w=0;
+    
+#ifdef HAVE_X11_XFT
+    if(font->font!=NULL && ioncore_g.enc_utf8){
+        /* Only Latin-1 code points are tabulated. */
+        while(i<len){
+            if(p[i]<0x80){
+                w+=get_advance(font, p[i]);
+                i++;
+            }else if((p[i]==0xC2 || p[i]==0xC3) && i+1<len 
+                     && (p[i+1]&0xC0)==0x80){
+                w+=get_advance(font, ((p[i]&0x1F)<<6)|(p[i+1]&0x3F));
+                i+=2;
+            }else{
+                return FALSE;
+            }
+        }
+        *ret=w;
+        return TRUE;
+    }
+#endif
+    
+    for(i=0; i<len; i++)
+        w+=get_advance(font, p[i]);
+    
+    *ret=w;
+    return TRUE;
+}
+
+
+/*}}}*/
+
+
+/*{{{ Width cache */
+
+
+static uint hash_string(const char *text, uint len)
+{
+    uint h=2166136261u;
+    uint i;
+    
+    for(i=0; i<len; i++){
+        h^=(unsigned char)text[i];
+        h*=16777619u;
+    }
+    
+    return h;
+}
+
+
+static void cache_remove(DEWidthCache *cache, DEWidthCacheEntry *ent)
+{
+    DEWidthCacheEntry **p=&cache->buckets[ent->hash&(DE_WIDTH_CACHE_BUCKETS-1)];
+    
+    while(*p!=ent)
+        p=&(*p)->hnext;
+    *p=ent->hnext;
+    
+    UNLINK_ITEM(cache->lru, ent, next, prev);
+    cache->n--;
+    
+    free(ent->str);
+    free(ent);
+}
+
+
+static bool cache_lookup(DEWidthCache *cache, const char *text, uint len,
+                         uint *ret)
+{
+    DEWidthCacheEntry *ent;
+    uint h;
+    
+    if(cache==NULL || len>DE_WIDTH_CACHE_MAXLEN)
+        return FALSE;
+    
+    h=hash_string(text, len);
+    
+    for(ent=cache->buckets[h&(DE_WIDTH_CACHE_BUCKETS-1)]; 
+        ent!=NULL; ent=ent->hnext){
+        if(ent->hash==h && ent->len==len 
+           && memcmp(ent->str, text, len)==0){
+            if(ent!=cache->lru){
+                UNLINK_ITEM(cache->lru, ent, next, prev);
+                LINK_ITEM_FIRST(cache->lru, ent, next, prev);
+            }
+            *ret=ent->width;
+            return TRUE;
+        }
+    }
+    
+    return FALSE;
+}
+
+
+bool defont_lookup_text_width(DEFont *font, const char *text, uint len,
+                              uint *ret)
+{
+    if(font->fixed_advance>0){
+        int n=count_chars(text, len);
+        if(n>=0){
+            *ret=n*font->fixed_advance;
+            return TRUE;
+        }
+    }else if(font->advances!=NULL){
+        if(sum_advances(font, text, len, ret))
+            return TRUE;
+    }
+    
+    return cache_lookup(font->widths, text, len, ret);
+}
+
+
+void defont_store_text_width(DEFont *font, const char *text, uint len,
+                             uint width)
+{
+    DEWidthCache *cache=font->widths;
+    DEWidthCacheEntry *ent;
+    uint b;
+    
+    if(len>DE_WIDTH_CACHE_MAXLEN)
+        return;
+    
+    if(cache==NULL){
+        cache=ALLOC(DEWidthCache);
+        if(cache==NULL)
+            return;
+        font->widths=cache;
+    }
+    
+    if(cache->n>=DE_WIDTH_CACHE_SIZE)
+        cache_remove(cache, cache->lru->prev);
+    
+    ent=ALLOC(DEWidthCacheEntry);
+    if(ent==NULL)
+        return;
+    
+    ent->str=ALLOC_N(char, len+1);
+    if(ent->str==NULL){
+        free(ent);
+        return;
+    }
+    
+    memcpy(ent->str, text, len);
+    ent->len=len;
+    ent->width=width;
+    ent->hash=hash_string(text, len);
+    
+    b=ent->hash&(DE_WIDTH_CACHE_BUCKETS-1);
+    ent->hnext=cache->buckets[b];
+    cache->buckets[b]=ent;
+    
+    LINK_ITEM_FIRST(cache->lru, ent, next, prev);
+    cache->n++;
+}
+
+
+void defont_deinit_advances(DEFont *font)
+{
+    if(font->widths!=NULL){
+        while(font->widths->lru!=NULL)
+            cache_remove(font->widths, font->widths->lru);
+        free(font->widths);
+        font->widths=NULL;
+    }
+    
+    if(font->advances!=NULL){
+        free(font->advances);
+        font->advances=NULL;
+    }
+}
+
+
+/*}}}*/
+
@@ -0,0 +1,58 @@
+/*
+ * ion/de/fontcache.h
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#ifndef ION_DE_FONTCACHE_H
+#define ION_DE_FONTCACHE_H
+
+#include <ioncore/common.h>
+
+INTRSTRUCT(DEWidthCache);
+INTRSTRUCT(DEWidthCacheEntry);
+
+#include "font.h"
+
+
+/* Number of measured strings remembered per font, and the number of
+ * hash buckets (a power of two) they are spread over. Strings longer
+ * than DE_WIDTH_CACHE_MAXLEN bytes are not cached.
+ */
+#define DE_WIDTH_CACHE_SIZE 256
+#define DE_WIDTH_CACHE_BUCKETS 128
+#define DE_WIDTH_CACHE_MAXLEN 512
+
+/* Advance tables cover the first DE_ADVANCE_TABLE_SIZE code points. */
+#define DE_ADVANCE_TABLE_SIZE 256
+#define DE_ADVANCE_UNKNOWN 0xffff
+
+
+DECLSTRUCT(DEWidthCacheEntry){
+    uint hash;
+    uint len;
+    uint width;
+    char *str;
+    DEWidthCacheEntry *hnext;
+    DEWidthCacheEntry *next, *prev;
+};
+
+
+DECLSTRUCT(DEWidthCache){
+    DEWidthCacheEntry *buckets[DE_WIDTH_CACHE_BUCKETS];
+    DEWidthCacheEntry *lru;
+    int n;
+};
+
+
+extern void defont_init_advances(DEFont *font);
+extern void defont_deinit_advances(DEFont *font);
+
+extern bool defont_lookup_text_width(DEFont *font, const char *text, 
+                                     uint len, uint *ret);
+extern void defont_store_text_width(DEFont *font, const char *text, 
+                                    uint len, uint width);
+
+#endif /* ION_DE_FONTCACHE_H */
@@ -0,0 +1,259 @@
+/*
+ * ion/de/gc.c
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#include <libtu/misc.h>
+#include <libextl/extl.h>
+#include <ioncore/common.h>
+#include <ioncore/global.h>
+#include "gc.h"
+
+
+/*{{{ GC state */
+
+
+enum{
+    DEGC_CLIP_UNKNOWN=0,
+    DEGC_CLIP_NONE,
+    DEGC_CLIP_RECT,
+    DEGC_CLIP_MASK
+};
+
+
+INTRSTRUCT(DEGCState);
+
+DECLSTRUCT(DEGCState){
+    GC gc;
+    
+    bool fg_ok, bg_ok, font_ok;
+    DEColour fg, bg;
+    Font font;
+    
+    int clip;
+    XRectangle clip_rect;
+    Pixmap clip_mask;
+    int clip_x, clip_y;
+    
+    DEGCState *next;
+};
+
+
+#define DEGC_BUCKETS 64
+
+
+static DEGCState *states[DEGC_BUCKETS];
+
+static ulong n_sent=0;
+static ulong n_saved=0;
+
+
+static uint gc_hash(GC gc)
+{
+    return (uint)(((ulong)gc>>4)%DEGC_BUCKETS);
+}
+
+
+/* States start out unknown, so the first change is always sent. */
+static DEGCState *get_state(GC gc)
+{
+    uint h=gc_hash(gc);
+    DEGCState *st;
+    
+    for(st=states[h]; st!=NULL; st=st->next){
+        if(st->gc==gc)
+            return st;
+    }
+    
+    st=ALLOC(DEGCState);
+    
+    if(st!=NULL){
+        st->gc=gc;
+        st->next=states[h];
+        states[h]=st;
+    }
+    
+    return st;
+}
+
+
+void degc_free(GC gc)
+{
+    DEGCState **p=&states[gc_hash(gc)];
+    
+    while(*p!=NULL){
+        if((*p)->gc==gc){
+            DEGCState *st=*p;
+            *p=st->next;
+            free(st);
+            return;
+        }
+        p=&(*p)->next;
+    }
+}
+
+
+void degc_deinit()
+{
+    int i;
+    
+    for(i=0; i<DEGC_BUCKETS; i++){
+        while(states[i]!=NULL){
+            DEGCState *st=states[i];
+            states[i]=st->next;
+            free(st);
+        }
+    }
+}
+
+
+/*}}}*/
+
+
+/*{{{ Setting values */
+
+
+void degc_set_foreground(GC gc, DEColour col)
+{
+    DEGCState *st=get_state(gc);
+    
+    if(st!=NULL){
+        if(st->fg_ok && st->fg==col){
+            n_saved++;
+            return;
+        }
+        st->fg=col;
+        st->fg_ok=TRUE;
+    }
+    
+    n_sent++;
+    XSetForeground(ioncore_g.dpy, gc, col);
+}
+
+
+void degc_set_background(GC gc, DEColour col)
+{
+    DEGCState *st=get_state(gc);
+    
+    if(st!=NULL){
+        if(st->bg_ok && st->bg==col){
+            n_saved++;
+            return;
+        }
+        st->bg=col;
+        st->bg_ok=TRUE;
+    }
+    
+    n_sent++;
+    XSetBackground(ioncore_g.dpy, gc, col);
+}
+
+
+void degc_set_font(GC gc, Font fid)
+{
+    DEGCState *st=get_state(gc);
+    
+    if(st!=NULL){
+        if(st->font_ok && st->font==fid){
+            n_saved++;
+            return;
+        }
+        st->font=fid;
+        st->font_ok=TRUE;
+    }
+    
+    n_sent++;
+    XSetFont(ioncore_g.dpy, gc, fid);
+}
+
+
+void degc_set_clip_rectangle(GC gc, const XRectangle *rect)
+{
+    DEGCState *st=get_state(gc);
+    
+    if(st!=NULL){
+        if(st->clip==DEGC_CLIP_RECT &&
+           st->clip_rect.x==rect->x && st->clip_rect.y==rect->y &&
+           st->clip_rect.width==rect->width && 
+           st->clip_rect.height==rect->height){
+            n_saved++;
+            return;
+        }
+        st->clip=DEGC_CLIP_RECT;
+        st->clip_rect=*rect;
+    }
+    
+    n_sent++;
+    XSetClipRectangles(ioncore_g.dpy, gc, 0, 0, (XRectangle*)rect, 
+                       1, Unsorted);
+}
+
+
+void degc_set_clip_mask(GC gc, Pixmap mask, int x, int y)
+{
+    DEGCState *st=get_state(gc);
+    
+    if(st!=NULL){
+        if(st->clip==DEGC_CLIP_MASK && st->clip_mask==mask &&
+           st->clip_x==x && st->clip_y==y){
+            n_saved+=2;
+            return;
+        }
+        st->clip=DEGC_CLIP_MASK;
+        st->clip_mask=mask;
+        st->clip_x=x;
+        st->clip_y=y;
+    }
+    
+    n_sent+=2;
+    XSetClipMask(ioncore_g.dpy, gc, mask);
+    XSetClipOrigin(ioncore_g.dpy, gc, x, y);
+}
+
+
+void degc_clear_clip(GC gc)
+{
+    DEGCState *st=get_state(gc);
+    
+    if(st!=NULL){
+        if(st->clip==DEGC_CLIP_NONE){
+            n_saved++;
+            return;
+        }
+        st->clip=DEGC_CLIP_NONE;
+    }
+    
+    n_sent++;
+    XSetClipMask(ioncore_g.dpy, gc, None);
+}
+
+
+/*}}}*/
+
+
+/*{{{ Statistics */
+
+
+/*EXTL_DOC
+ * Returns a table with the number of GC change requests issued 
+ * (\var{sent}) and avoided as redundant (\var{saved}) by the drawing 
+ * engine so far.
+ */
+EXTL_SAFE
+EXTL_EXPORT
+ExtlTab de_gc_stats()
+{
+    ExtlTab tab=extl_create_table();
+    
+    extl_table_sets_i(tab, "sent", (int)n_sent);
+    extl_table_sets_i(tab, "saved", (int)n_saved);
+    
+    return tab;
+}
+
+
+/*}}}*/
+
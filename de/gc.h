@@ -0,0 +1,36 @@
+/*
+ * ion/de/gc.h
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009. 
+ *
+ * See the included file LICENSE for details.
+ */
+
+#ifndef ION_DE_GC_H
+#define ION_DE_GC_H
+
+#include <ioncore/common.h>
+#include <libextl/extl.h>
+
+#include "colour.h"
+
+
+/* Thin wrappers for changing the state of the GCs used by the drawing 
+ * engine. The last state set through these is remembered per GC, and
+ * requests that would not change it are not issued. GCs must be 
+ * forgotten with degc_free before (or instead of) XFreeGC.
+ */
+
+extern void degc_set_foreground(GC gc, DEColour col);
+extern void degc_set_background(GC gc, DEColour col);
+extern void degc_set_font(GC gc, Font fid);
+extern void degc_set_clip_rectangle(GC gc, const XRectangle *rect);
+extern void degc_set_clip_mask(GC gc, Pixmap mask, int x, int y);
+extern void degc_clear_clip(GC gc);
+
+extern void degc_free(GC gc);
+extern void degc_deinit();
+
+extern ExtlTab de_gc_stats();
+
+#endif /* ION_DE_GC_H */
@@ -19,6 +19,9 @@
 
 #include "brush.h"
 #include "font.h"
+#include "gc.h"
+#include "batch.h"
+#include "shape.h"
 #include "colour.h"
 #include "private.h"
 #include "init.h"
@@ -265,6 +268,15 @@ void de_get_transparent_background(uint *mode, ExtlTab tab)
 }
 
 
+void de_get_back_buffer(bool *ret, ExtlTab tab)
+{
+    bool b;
+    
+    if(extl_table_gets_b(tab, "back_buffer", &b))
+        *ret=b;
+}
+
+
 /*}}}*/
 
 
@@ -286,6 +298,7 @@ static const char * const known_values[]={
     "highlight_colour",
     "padding_colour",
     "text_align",
+    "back_buffer",
     NULL
 };
 
@@ -325,6 +338,132 @@ static void filter_extras(ExtlTab *tgt, ExtlTab src)
 /*}}}*/
 
 
+/*{{{ Definition comparison */
+
+
+INTRSTRUCT(DETableCmp);
+
+DECLSTRUCT(DETableCmp){
+    ExtlTab other;
+    int n;
+    bool equal;
+};
+
+
+static bool values_equal(const ExtlAny *a, const ExtlAny *b)
+{
+    switch(a->type){
+    case 's':
+    case 'S':
+        return ((b->type=='s' || b->type=='S') && 
+                strcmp(a->value.s, b->value.s)==0);
+    case 'd':
+        return (b->type=='d' && a->value.d==b->value.d);
+    case 'i':
+        return (b->type=='i' && a->value.i==b->value.i);
+    case 'o':
+        return (b->type=='o' && a->value.o==b->value.o);
+    case 'f':
+        return (b->type=='f' && extl_fn_eq(a->value.f, b->value.f));
+    case 't':
+        return (b->type=='t' && de_tables_equal(a->value.t, b->value.t));
+    }
+    
+    return FALSE;
+}
+
+
+static void free_value(ExtlAny *a)
+{
+    if(a->type=='s')
+        free((char*)a->value.s);
+    else if(a->type=='t')
+        extl_unref_table(a->value.t);
+    else if(a->type=='f')
+        extl_unref_fn(a->value.f);
+}
+
+
+static bool cmp_iter_fn(ExtlAny k, ExtlAny v, void *p)
+{
+    DETableCmp *cmp=(DETableCmp*)p;
+    ExtlAny w;
+    
+    cmp->n++;
+    
+    if(!extl_table_get(cmp->other, 'a', 'a', k, &w)){
+        cmp->equal=FALSE;
+        return FALSE;
+    }
+    
+    cmp->equal=values_equal(&v, &w);
+    
+    free_value(&w);
+    
+    return cmp->equal;
+}
+
+
+static bool count_iter_fn(ExtlAny k, ExtlAny v, void *p)
+{
+    (*(int*)p)++;
+    return TRUE;
+}
+
+
+/* Deep comparison of style definition tables. Like filter_extras, 
+ * this only sees values that the iterator can convert; booleans are
+ * not among them, so the known boolean settings are compared 
+ * separately.
+ */
+bool de_tables_equal(ExtlTab a, ExtlTab b)
+{
+    DETableCmp cmp;
+    int nb=0;
+    
+    if(extl_table_eq(a, b))
+        return TRUE;
+    
+    cmp.other=b;
+    cmp.n=0;
+    cmp.equal=TRUE;
+    
+    extl_table_iter(a, cmp_iter_fn, &cmp);
+    
+    if(!cmp.equal)
+        return FALSE;
+    
+    extl_table_iter(b, count_iter_fn, &nb);
+    
+    return (nb==cmp.n);
+}
+
+
+static bool same_bool(ExtlTab a, ExtlTab b, const char *key)
+{
+    bool va=FALSE, vb=FALSE;
+    
+    extl_table_gets_b(a, key, &va);
+    extl_table_gets_b(b, key, &vb);
+    
+    return (va==vb);
+}
+
+
+bool destyle_defined_as(DEStyle *style, ExtlTab tab)
+{
+    if(style->def_tab==extl_table_none())
+        return FALSE;
+    
+    return (same_bool(style->def_tab, tab, "transparent_background") &&
+            same_bool(style->def_tab, tab, "back_buffer") &&
+            de_tables_equal(style->def_tab, tab));
+}
+
+
+/*}}}*/
+
+
 /*{{{ de_defstyle */
 
 
@@ -337,6 +476,7 @@ void de_get_nonfont(WRootWin *rootwin, DEStyle *style, ExtlTab tab)
         style->transparency_mode=based_on->transparency_mode;
         style->textalign=based_on->textalign;
         style->spacing=based_on->spacing;
+        style->back_buffer=based_on->back_buffer;
     }
     
     de_get_border(&(style->border), tab);
@@ -345,6 +485,8 @@ void de_get_nonfont(WRootWin *rootwin, DEStyle *style, ExtlTab tab)
     de_get_text_align(&(style->textalign), tab);
 
     de_get_transparent_background(&(style->transparency_mode), tab);
+    
+    de_get_back_buffer(&(style->back_buffer), tab);
 
     style->cgrp_alloced=TRUE;
     de_get_colour_group(rootwin, &(style->cgrp), tab, based_on);
@@ -364,13 +506,12 @@ bool de_defstyle_rootwin(WRootWin *rootwin, const char *name, ExtlTab tab)
     int based_on_score=-1;
     char *fnt, *bss;
     uint n;
+    GrStyleSpec spec;
 
     if(name==NULL)
         return FALSE;
     
-    style=de_create_style(rootwin, name);
-    
-    if(style==NULL)
+    if(!gr_stylespec_load(&spec, name))
         return FALSE;
     
     if(extl_table_gets_s(tab, "based_on", &bss)){
@@ -383,9 +524,26 @@ bool de_defstyle_rootwin(WRootWin *rootwin, const char *name, ExtlTab tab)
         gr_stylespec_unalloc(&bs);
         free(bss);
     }else{
-        based_on=de_get_style(rootwin, &style->spec);
+        based_on=de_get_style(rootwin, &spec);
     }
     
+    /* An unchanged definition from before the last de_reset is taken 
+     * back as is, along with its GCs, font and colours.
+     */
+    style=de_take_old_style(rootwin, &spec, based_on, tab);
+    
+    gr_stylespec_unalloc(&spec);
+    
+    if(style!=NULL){
+        destyle_add(style);
+        return TRUE;
+    }
+    
+    style=de_create_style(rootwin, name);
+    
+    if(style==NULL)
+        return FALSE;
+    
     if(based_on!=NULL){
         style->based_on=based_on;
         based_on->usecount++;
@@ -449,6 +607,8 @@ bool de_defstyle_rootwin(WRootWin *rootwin, const char *name, ExtlTab tab)
     
     filter_extras(&style->extras_table, tab);
     
+    style->def_tab=extl_ref_table(tab);
+    
     destyle_add(style);
     
     return TRUE;
@@ -507,6 +667,8 @@ bool de_init()
     if(!gr_register_engine("de", (GrGetBrushFn*)&de_get_brush))
         goto fail;
     
+    de_init_styles();
+    
     /* Create fallback brushes */
     FOR_ALL_ROOTWINS(rootwin){
         style=de_create_style(rootwin, "*");
@@ -529,6 +691,10 @@ void de_deinit()
     gr_unregister_engine("de");
     de_unregister_exports();
     de_deinit_styles();
+    debuffer_deinit();
+    debatch_deinit();
+    deshape_deinit();
+    degc_deinit();
 }
 
 
@@ -26,8 +26,13 @@ extern void de_get_text_align(int *alignret, ExtlTab tab);
 
 extern void de_get_transparent_background(uint *mode, ExtlTab tab);
 
+extern void de_get_back_buffer(bool *ret, ExtlTab tab);
+
 extern void de_get_nonfont(WRootWin *rw, DEStyle *style, ExtlTab tab);
 
+extern bool de_tables_equal(ExtlTab a, ExtlTab b);
+extern bool destyle_defined_as(DEStyle *style, ExtlTab tab);
+
 extern bool de_defstyle_rootwin(WRootWin *rootwin, const char *name, 
                                 ExtlTab tab);
 extern bool de_defstyle(const char *name, ExtlTab tab);
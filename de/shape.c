@@ -0,0 +1,218 @@
+/*
+ * ion/de/shape.c
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009.
+ *
+ * See the included file LICENSE for details.
+ */
+
+#include <string.h>
+
+#include <libtu/misc.h>
+#include <ioncore/common.h>
+#include <ioncore/global.h>
+#include "shape.h"
+
+#include <X11/extensions/shape.h>
+
+
+/*{{{ Shape state */
+
+
+INTRSTRUCT(DEShapeState);
+
+DECLSTRUCT(DEShapeState){
+    Window win;
+    int n;
+    XRectangle rects[DESHAPE_MAX];
+    DEShapeState *next;
+};
+
+
+#define DESHAPE_BUCKETS 32
+
+
+static DEShapeState *states[DESHAPE_BUCKETS];
+
+
+static uint win_hash(Window win)
+{
+    return (uint)(win%DESHAPE_BUCKETS);
+}
+
+
+static DEShapeState *get_state(Window win)
+{
+    uint h=win_hash(win);
+    DEShapeState *st;
+    
+    for(st=states[h]; st!=NULL; st=st->next){
+        if(st->win==win)
+            return st;
+    }
+    
+    st=ALLOC(DEShapeState);
+    
+    if(st!=NULL){
+        st->win=win;
+        /* Nothing known about the current shape. */
+        st->n=-1;
+        st->next=states[h];
+        states[h]=st;
+    }
+    
+    return st;
+}
+
+
+void deshape_forget(Window win)
+{
+    DEShapeState **p=&states[win_hash(win)];
+    
+    while(*p!=NULL){
+        if((*p)->win==win){
+            DEShapeState *st=*p;
+            *p=st->next;
+            free(st);
+            return;
+        }
+        p=&(*p)->next;
+    }
+}
+
+
+void deshape_deinit()
+{
+    int i;
+    
+    for(i=0; i<DESHAPE_BUCKETS; i++){
+        while(states[i]!=NULL){
+            DEShapeState *st=states[i];
+            states[i]=st->next;
+            free(st);
+        }
+    }
+}
+
+
+/*}}}*/
+
+
+/*{{{ Setting the shape */
+
+
+static bool rect_eq(const XRectangle *a, const XRectangle *b)
+{
+    return (a->x==b->x && a->y==b->y && 
+            a->width==b->width && a->height==b->height);
+}
+
+
+static bool rect_contains(const XRectangle *a, const XRectangle *b)
+{
+    return (b->x>=a->x && b->y>=a->y &&
+            b->x+(int)b->width<=a->x+(int)a->width &&
+            b->y+(int)b->height<=a->y+(int)a->height);
+}
+
+
+static bool rect_overlaps(const XRectangle *a, const XRectangle *b)
+{
+    return (a->x<b->x+(int)b->width && b->x<a->x+(int)a->width &&
+            a->y<b->y+(int)b->height && b->y<a->y+(int)a->height);
+}
+
+
+static void combine(Window win, XRectangle *r, int n, int op)
+{
+    XShapeCombineRectangles(ioncore_g.dpy, win, ShapeBounding, 0, 0, 
+                            r, n, op, Unsorted);
+}
+
+
+/* Try to turn a change of the single rectangle 'o' into 'r' into a 
+ * union or subtraction that leaves the others alone. 
+ */
+static bool set_delta(Window win, const DEShapeState *st, int k,
+                      const XRectangle *r)
+{
+    const XRectangle *o=&st->rects[k];
+    XRectangle d[4];
+    int i, n=0;
+    
+    if(rect_contains(r, o)){
+        combine(win, (XRectangle*)r, 1, ShapeUnion);
+        return TRUE;
+    }
+    
+    if(!rect_contains(o, r))
+        return FALSE;
+    
+    /* Removing o\r must not cut into the other rectangles. */
+    for(i=0; i<st->n; i++){
+        if(i!=k && rect_overlaps(&st->rects[i], o))
+            return FALSE;
+    }
+    
+    if(r->y>o->y){
+        d[n].x=o->x; d[n].y=o->y; 
+        d[n].width=o->width; d[n].height=r->y-o->y;
+        n++;
+    }
+    if(r->y+r->height<o->y+o->height){
+        d[n].x=o->x; d[n].y=r->y+r->height; 
+        d[n].width=o->width; d[n].height=o->y+o->height-r->y-r->height;
+        n++;
+    }
+    if(r->x>o->x){
+        d[n].x=o->x; d[n].y=r->y;
+        d[n].width=r->x-o->x; d[n].height=r->height;
+        n++;
+    }
+    if(r->x+r->width<o->x+o->width){
+        d[n].x=r->x+r->width; d[n].y=r->y;
+        d[n].width=o->x+o->width-r->x-r->width; d[n].height=r->height;
+        n++;
+    }
+    
+    if(n>0)
+        combine(win, d, n, ShapeSubtract);
+    
+    return TRUE;
+}
+
+
+void deshape_set(Window win, int n, const XRectangle *rects)
+{
+    DEShapeState *st=get_state(win);
+    int i, changed=-1, nchanged=0;
+    
+    if(n>DESHAPE_MAX)
+        n=DESHAPE_MAX;
+    
+    if(st==NULL){
+        combine(win, (XRectangle*)rects, n, ShapeSet);
+        return;
+    }
+    
+    if(st->n==n){
+        for(i=0; i<n; i++){
+            if(!rect_eq(&st->rects[i], &rects[i])){
+                changed=i;
+                nchanged++;
+            }
+        }
+        
+        if(nchanged==0)
+            return;
+    }
+    
+    if(!(nchanged==1 && set_delta(win, st, changed, &rects[changed])))
+        combine(win, (XRectangle*)rects, n, ShapeSet);
+    
+    st->n=n;
+    memcpy(st->rects, rects, n*sizeof(XRectangle));
+}
+
+
+/*}}}*/
@@ -0,0 +1,27 @@
+/*
+ * ion/de/shape.h
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009.
+ *
+ * See the included file LICENSE for details.
+ */
+
+#ifndef ION_DE_SHAPE_H
+#define ION_DE_SHAPE_H
+
+#include <ioncore/common.h>
+
+#define DESHAPE_MAX 16
+
+
+/* The bounding shape last set on each window is remembered, so that 
+ * setting the same shape again costs nothing, and a change to a single
+ * rectangle can often be sent as a union or a subtraction. Windows
+ * must be forgotten with deshape_forget before they are destroyed.
+ */
+
+extern void deshape_set(Window win, int n, const XRectangle *rects);
+extern void deshape_forget(Window win);
+extern void deshape_deinit();
+
+#endif /* ION_DE_SHAPE_H */
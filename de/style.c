@@ -19,7 +19,9 @@
 #include "font.h"
 #include "colour.h"
 #include "private.h"
+#include "gc.h"
 #include "style.h"
+#include "init.h"
 
 
 /*{{{ GC creation */
@@ -116,10 +118,17 @@ void destyle_create_tab_gcs(DEStyle *style)
 static DEStyle *styles=NULL;
 
 
+static DEAttrCache style_cache;
+
+
 DEStyle *de_get_style(WRootWin *rootwin, const GrStyleSpec *spec)
 {
     DEStyle *style, *maxstyle=NULL;
     int score, maxscore=0;
+    void *cached;
+    
+    if(deattrcache_lookup(&style_cache, rootwin, spec, NULL, &cached))
+        return (DEStyle*)cached;
     
     for(style=styles; style!=NULL; style=style->next){
         if(style->rootwin!=rootwin)
@@ -131,6 +140,9 @@ DEStyle *de_get_style(WRootWin *rootwin, const GrStyleSpec *spec)
         }
     }
     
+    if(maxstyle!=NULL)
+        deattrcache_store(&style_cache, rootwin, spec, NULL, maxstyle);
+    
     return maxstyle;
 }
 
@@ -157,6 +169,9 @@ void destyle_deinit(DEStyle *style)
     
     UNLINK_ITEM(styles, style, next, prev);
     
+    deattrcache_flush(&style->cgrp_cache);
+    deattrcache_invalidate_all();
+    
     gr_stylespec_unalloc(&style->spec);
     
     if(style->font!=NULL){
@@ -174,10 +189,14 @@ void destyle_deinit(DEStyle *style)
         free(style->extra_cgrps);
     
     extl_unref_table(style->extras_table);
+    extl_unref_table(style->def_tab);
     
+    degc_free(style->normal_gc);
     XFreeGC(ioncore_g.dpy, style->normal_gc);
     
     if(style->tabbrush_data_ok){
+        degc_free(style->copy_gc);
+        degc_free(style->stipple_gc);
         XFreeGC(ioncore_g.dpy, style->copy_gc);
         XFreeGC(ioncore_g.dpy, style->stipple_gc);
         XFreePixmap(ioncore_g.dpy, style->tag_pixmap);
@@ -196,6 +215,7 @@ void destyle_dump(DEStyle *style)
 {
     /* Allow the style still be used but get if off the list. */
     UNLINK_ITEM(styles, style, next, prev);
+    deattrcache_invalidate_all();
     destyle_unref(style);
 }
 
@@ -234,11 +254,14 @@ bool destyle_init(DEStyle *style, WRootWin *rootwin, const char *name)
     style->font=NULL;
     
     style->transparency_mode=GR_TRANSPARENCY_NO;
+    style->back_buffer=FALSE;
     
     style->n_extra_cgrps=0;
     style->extra_cgrps=NULL;
+    deattrcache_init(&style->cgrp_cache);
     
     style->extras_table=extl_table_none();
+    style->def_tab=extl_table_none();
     
     create_normal_gc(style, rootwin);
     
@@ -264,6 +287,45 @@ DEStyle *de_create_style(WRootWin *rootwin, const char *name)
 void destyle_add(DEStyle *style)
 {
     LINK_ITEM_FIRST(styles, style, next, prev);
+    deattrcache_invalidate_all();
+}
+
+
+/* Styles cleared by de_reset are kept here, with the reference the
+ * style list had, until the first brush is requested after the reset.
+ * Until then a redefinition of a style that does not differ from the
+ * old one may take it back instead of creating a new style.
+ */
+static DEStyle *old_styles=NULL;
+
+
+DEStyle *de_take_old_style(WRootWin *rootwin, const GrStyleSpec *spec,
+                           DEStyle *based_on, ExtlTab tab)
+{
+    DEStyle *style;
+    
+    for(style=old_styles; style!=NULL; style=style->next){
+        if(style->rootwin==rootwin && style->based_on==based_on &&
+           gr_stylespec_equals(&style->spec, spec) &&
+           destyle_defined_as(style, tab)){
+            UNLINK_ITEM(old_styles, style, next, prev);
+            return style;
+        }
+    }
+    
+    return NULL;
+}
+
+
+void de_drop_old_styles()
+{
+    DEStyle *style;
+    
+    while(old_styles!=NULL){
+        style=old_styles;
+        UNLINK_ITEM(old_styles, style, next, prev);
+        destyle_unref(style);
+    }
 }
 
 
@@ -274,17 +336,34 @@ EXTL_EXPORT
 void de_reset()
 {
     DEStyle *style, *next;
+    
+    debrush_flush_shared();
+    de_drop_old_styles();
+    
     for(style=styles; style!=NULL; style=next){
         next=style->next;
-        if(!style->is_fallback)
-            destyle_dump(style);
+        if(!style->is_fallback){
+            UNLINK_ITEM(styles, style, next, prev);
+            LINK_ITEM(old_styles, style, next, prev);
+        }
     }
+    
+    deattrcache_invalidate_all();
+}
+
+
+void de_init_styles()
+{
+    deattrcache_init(&style_cache);
 }
 
 
 void de_deinit_styles()
 {
     DEStyle *style, *next;
+    debrush_flush_shared();
+    deattrcache_flush(&style_cache);
+    de_drop_old_styles();
     for(style=styles; style!=NULL; style=next){
         next=style->next;
         if(style->usecount>1){
@@ -20,6 +20,7 @@ INTRSTRUCT(DEStyle);
 
 #include "font.h"
 #include "colour.h"
+#include "attrcache.h"
 
 enum{
     DEBORDER_INLAID=0,    /* -\xxxxxx/- */
@@ -65,12 +66,16 @@ DECLSTRUCT(DEStyle){
     DEColourGroup cgrp;
     int n_extra_cgrps;
     DEColourGroup *extra_cgrps;
+    DEAttrCache cgrp_cache;
     GrTransparency transparency_mode;
+    bool back_buffer;
     DEFont *font;
     int textalign;
     uint spacing;
     
     ExtlTab extras_table;
+    /* The table the style was defined from, if any. */
+    ExtlTab def_tab;
 
     /* Only initialised if used as a DETabBrush */
     bool tabbrush_data_ok;
@@ -92,7 +97,12 @@ extern void destyle_unref(DEStyle *style);
 
 extern void destyle_create_tab_gcs(DEStyle *style);
 
+extern DEStyle *de_take_old_style(WRootWin *rootwin, const GrStyleSpec *spec,
+                                  DEStyle *based_on, ExtlTab tab);
+extern void de_drop_old_styles();
+
 extern void de_reset();
+extern void de_init_styles();
 extern void de_deinit_styles();
 
 extern DEStyle *de_get_style(WRootWin *rootwin, const GrStyleSpec *spec);
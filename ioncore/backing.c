@@ -0,0 +1,186 @@
+/*
+ * ion/ioncore/backing.c
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009.
+ *
+ * See the included file LICENSE for details.
+ */
+
+#include <string.h>
+
+#include <libtu/objp.h>
+#include <libextl/extl.h>
+
+#include "common.h"
+#include "global.h"
+#include "rootwin.h"
+#include "backing.h"
+
+
+/*{{{ Policy */
+
+
+/* Windows of these classes (or their subclasses) come and go often
+ * enough that it pays to have the server save what is under them,
+ * instead of making the windows below redraw themselves.
+ */
+static const char *default_save_under[]={
+    "WMenu",
+    "WInput",
+    "WInfoWin",
+    NULL
+};
+
+static const char *default_backing_store[]={
+    NULL
+};
+
+static char **save_under=(char**)default_save_under;
+static char **backing_store=(char**)default_backing_store;
+
+
+static bool list_match(char **list, const Obj *obj)
+{
+    for(; *list!=NULL; list++){
+        if(obj_is_str(obj, *list))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+
+static void list_free(char **list)
+{
+    char **l;
+
+    if(list==(char**)default_save_under ||
+       list==(char**)default_backing_store){
+        return;
+    }
+
+    for(l=list; *l!=NULL; l++)
+        free(*l);
+
+    free(list);
+}
+
+
+static char **list_get(ExtlTab tab)
+{
+    int i, j, n=extl_table_get_n(tab);
+    char **list=ALLOC_N(char*, n+1);
+
+    if(list==NULL)
+        return NULL;
+
+    for(i=1, j=0; i<=n; i++){
+        if(extl_table_geti_s(tab, i, &(list[j])))
+            j++;
+    }
+
+    list[j]=NULL;
+
+    return list;
+}
+
+
+static ExtlTab list_to_table(char **list)
+{
+    ExtlTab tab=extl_create_table();
+    int i;
+
+    for(i=0; list[i]!=NULL; i++)
+        extl_table_seti_s(tab, i+1, list[i]);
+
+    return tab;
+}
+
+
+static void set_list(ExtlTab tab, const char *name, char ***list)
+{
+    ExtlTab t;
+    char **l;
+
+    if(!extl_table_gets_t(tab, name, &t))
+        return;
+
+    l=list_get(t);
+
+    extl_unref_table(t);
+
+    if(l!=NULL){
+        list_free(*list);
+        *list=l;
+    }
+}
+
+
+void ioncore_backing_set(ExtlTab tab)
+{
+    set_list(tab, "save_under", &save_under);
+    set_list(tab, "backing_store", &backing_store);
+}
+
+
+void ioncore_backing_get(ExtlTab tab)
+{
+    ExtlTab t;
+
+    t=list_to_table(save_under);
+    extl_table_sets_t(tab, "save_under", t);
+    extl_unref_table(t);
+
+    t=list_to_table(backing_store);
+    extl_table_sets_t(tab, "backing_store", t);
+    extl_unref_table(t);
+}
+
+
+void ioncore_backing_deinit()
+{
+    list_free(save_under);
+    save_under=(char**)default_save_under;
+    list_free(backing_store);
+    backing_store=(char**)default_backing_store;
+}
+
+
+/*}}}*/
+
+
+/*{{{ Applying */
+
+
+/* Set the save-under and backing-store attributes of the X window of
+ * wwin according to its class, as far as the server supports them.
+ */
+void window_apply_backing(WWindow *wwin)
+{
+    WRootWin *rw=region_rootwin_of((WRegion*)wwin);
+    Screen *scr;
+    XSetWindowAttributes attr;
+    ulong mask=0;
+
+    if(rw==NULL)
+        return;
+
+    scr=ScreenOfDisplay(ioncore_g.dpy, rw->xscr);
+
+    if(DoesSaveUnders(scr) && list_match(save_under, (Obj*)wwin)){
+        attr.save_under=True;
+        mask|=CWSaveUnder;
+    }
+
+    if(DoesBackingStore(scr)!=NotUseful
+       && list_match(backing_store, (Obj*)wwin)){
+        attr.backing_store=WhenMapped;
+        mask|=CWBackingStore;
+    }
+
+    if(mask!=0)
+        XChangeWindowAttributes(ioncore_g.dpy, wwin->win, mask, &attr);
+}
+
+
+/*}}}*/
@@ -0,0 +1,22 @@
+/*
+ * ion/ioncore/backing.h
+ *
+ * Copyright (c) Tuomo Valkonen 1999-2009.
+ *
+ * See the included file LICENSE for details.
+ */
+
+#ifndef ION_IONCORE_BACKING_H
+#define ION_IONCORE_BACKING_H
+
+#include <libextl/extl.h>
+#include "common.h"
+#include "window.h"
+
+extern void ioncore_backing_set(ExtlTab tab);
+extern void ioncore_backing_get(ExtlTab tab);
+extern void ioncore_backing_deinit();
+
+extern void window_apply_backing(WWindow *wwin);
+
+#endif /* ION_IONCORE_BACKING_H */
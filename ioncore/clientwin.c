@@ -604,6 +604,7 @@ WClientWin* ioncore_manage_clientwin(Window win, bool maprq)
         /*if(param.jumpto && ioncore_g.focus_next==NULL)*/
         if(param.jumpto && !region_manager_is_focusnext((WRegion*)cwin))
             region_goto((WRegion*)cwin);
+        netwm_client_list_add(cwin);
         hook_call_o(clientwin_mapped_hook, (Obj*)cwin);
         return cwin;
     }
@@ -719,6 +720,8 @@ void clientwin_deinit(WClientWin *cwin)
     
     clientwin_clear_colormaps(cwin);
     
+    netwm_client_list_remove(cwin);
+    
     region_deinit((WRegion*)cwin);
 }
 
@@ -873,13 +876,15 @@ static void show_clientwin(WClientWin *cwin)
 /*{{{ Resize/reparent/reconf helpers */
 
 
-void clientwin_notify_rootpos(WClientWin *cwin, int rootx, int rooty)
+static void do_sendconfig_clientwin(WClientWin *cwin)
 {
     XEvent ce;
     Window win;
+    int rootx, rooty;
     
-    if(cwin==NULL)
-        return;
+    cwin->flags&=~CLIENTWIN_CFGNTFY_SCHEDULED;
+    
+    region_rootpos(&cwin->region, &rootx, &rooty);
     
     win=cwin->win;
     
@@ -900,12 +905,34 @@ void clientwin_notify_rootpos(WClientWin *cwin, int rootx, int rooty)
 }
 
 
+/* Synthetic ConfigureNotify events are coalesced until we return to
+ * the main loop, so that the client only sees the final geometry of
+ * e.g. a split resize or a workspace switch, not every step of it.
+ */
 static void sendconfig_clientwin(WClientWin *cwin)
 {
-    int rootx, rooty;
+    if(cwin->flags&CLIENTWIN_CFGNTFY_SCHEDULED
+       || OBJ_IS_BEING_DESTROYED(cwin)){
+        return;
+    }
     
-    region_rootpos(&cwin->region, &rootx, &rooty);
-    clientwin_notify_rootpos(cwin, rootx, rooty);
+    if(ioncore_g.opmode!=IONCORE_OPMODE_DEINIT &&
+       mainloop_defer_action((Obj*)cwin, 
+                             (WDeferredAction*)do_sendconfig_clientwin)){
+        cwin->flags|=CLIENTWIN_CFGNTFY_SCHEDULED;
+    }else{
+        do_sendconfig_clientwin(cwin);
+    }
+}
+
+
+void clientwin_notify_rootpos(WClientWin *cwin, int rootx, int rooty)
+{
+    /* The position is recalculated when the notification is actually
+     * sent, as the window may still be moved further before that.
+     */
+    if(cwin!=NULL)
+        sendconfig_clientwin(cwin);
 }
 
 
@@ -1001,6 +1028,7 @@ static void clientwin_map(WClientWin *cwin)
 {
     show_clientwin(cwin);
     REGION_MARK_MAPPED(cwin);
+    netwm_client_list_raise(cwin);
 }
 
 
@@ -1027,6 +1055,8 @@ static void clientwin_do_set_focus(WClientWin *cwin, bool warp)
 void clientwin_restack(WClientWin *cwin, Window other, int mode)
 {
     xwindow_restack(cwin->win, other, mode);
+    if(mode==Above)
+        netwm_client_list_raise(cwin);
 }
        
 
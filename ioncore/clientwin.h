@@ -41,6 +41,7 @@
 #define CLIENTWIN_NEED_CFGNTFY       0x80000
 #define CLIENTWIN_PROP_O_VERT       0x100000
 #define CLIENTWIN_PROP_O_HORIZ      0x200000
+#define CLIENTWIN_CFGNTFY_SCHEDULED 0x400000
 
 DECLCLASS(WClientWin){
     WRegion region;
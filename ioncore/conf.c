@@ -24,6 +24,7 @@
 #include "reginfo.h"
 #include "group-ws.h"
 #include "llist.h"
+#include "backing.h"
 
 
 StringIntMap frame_idxs[]={
@@ -50,6 +51,11 @@ static ExtlFn get_layout_fn;
  *                        resize operations simply draw a rubberband during
  *                        the operation (false) or immediately affect the 
  *                        object in question at every step (true). \\
+ *  \var{rubberband} & (string) How to draw the rubberband: 
+ *                     \codestr{outline} (default) uses small windows,
+ *                     \codestr{xor} draws on the root window, which 
+ *                     requires freezing other clients during the 
+ *                     operation. \\
  *  \var{warp} &          (boolean) Should focusing operations move the 
  *                        pointer to the object to be focused? \\
  *  \var{switchto} &      (boolean) Should a managing \type{WMPlex} switch
@@ -71,6 +77,9 @@ static ExtlFn get_layout_fn;
  *  \var{kbresize_step} & (floating point) See below. \\
  *  \var{kbresize_maxacc} & (floating point) See below. \\
  *  \var{edge_resistance} & (integer) Resize edge resistance in pixels. \\
+ *  \var{moveres_rate} & (integer) Maximum number of times per second 
+ *                        that opaque moves and resizes with the pointing
+ *                        device are applied. Zero means no limit. \\
  *  \var{framed_transients} & (boolean) Put transients in nested frames. \\
  *  \var{float_placement_method} & (string) How to place floating frames.
  *                          One of \codestr{udlr} (up-down, then left-right), 
@@ -80,6 +89,16 @@ static ExtlFn get_layout_fn;
  *                     \codestr{disabled} or \codestr{sloppy}. \\
  *  \var{unsqueeze} & (boolean) Auto-unsqueeze transients/menus/queries/etc. \\
  *  \var{autoraise} & (boolean) Autoraise regions in groups on goto. \\
+ *  \var{drag_rate} & (integer) Maximum number of times per second that
+ *                     a dragged tab is moved. Zero means no limit. \\
+ *  \var{save_under} & (table) Names of the classes of regions, such as
+ *                      \type{WMenu}, for whose windows the X server
+ *                      should save the contents under them when mapped,
+ *                      if it supports this. Default: \type{WMenu}, 
+ *                      \type{WInput}, \type{WInfoWin}. \\
+ *  \var{backing_store} & (table) Names of the classes of regions whose
+ *                      windows the X server should keep backing store 
+ *                      for, if it supports this. Default: none. \\
  * \end{tabularx}
  * 
  * When a keyboard resize function is called, and at most \var{kbresize_t_max} 
@@ -113,6 +132,14 @@ void ioncore_set(ExtlTab tab)
         free(tmp);
     }
 
+    if(extl_table_gets_s(tab, "rubberband", &tmp)){
+        if(strcmp(tmp, "xor")==0)
+            ioncore_g.xor_rubberband=TRUE;
+        else if(strcmp(tmp, "outline")==0)
+            ioncore_g.xor_rubberband=FALSE;
+        free(tmp);
+    }
+    
     if(extl_table_gets_s(tab, "mousefocus", &tmp)){
         if(strcmp(tmp, "disabled")==0)
             ioncore_g.no_mousefocus=TRUE;
@@ -124,10 +151,15 @@ void ioncore_set(ExtlTab tab)
     if(extl_table_gets_i(tab, "dblclick_delay", &dd))
         ioncore_g.dblclick_delay=maxof(0, dd);
     
+    if(extl_table_gets_i(tab, "drag_rate", &dd))
+        ioncore_g.drag_rate=maxof(0, dd);
+    
     ioncore_set_moveres_accel(tab);
     
     ioncore_groupws_set(tab);
     
+    ioncore_backing_set(tab);
+    
     /* Internal -- therefore undocumented above */
     if(extl_table_gets_f(tab, "_get_winprop", &fn)){
         if(get_winprop_fn_set)
@@ -159,6 +191,7 @@ ExtlTab ioncore_get()
     extl_table_sets_b(tab, "warp", ioncore_g.warp_enabled);
     extl_table_sets_b(tab, "switchto", ioncore_g.switchto_new);
     extl_table_sets_i(tab, "dblclick_delay", ioncore_g.dblclick_delay);
+    extl_table_sets_i(tab, "drag_rate", ioncore_g.drag_rate);
     extl_table_sets_b(tab, "screen_notify", ioncore_g.screen_notify);
     extl_table_sets_b(tab, "framed_transients", ioncore_g.framed_transients);
     extl_table_sets_b(tab, "unsqueeze", ioncore_g.unsqueeze_enabled);
@@ -170,6 +203,10 @@ ExtlTab ioncore_get()
                                        ioncore_g.frame_default_index,
                                        NULL));
     
+    extl_table_sets_s(tab, "rubberband", (ioncore_g.xor_rubberband
+                                          ? "xor" 
+                                          : "outline"));
+    
     extl_table_sets_s(tab, "mousefocus", (ioncore_g.no_mousefocus
                                           ? "disabled" 
                                           : "sloppy"));
@@ -178,6 +215,8 @@ ExtlTab ioncore_get()
     
     ioncore_groupws_get(tab);
     
+    ioncore_backing_get(tab);
+    
     return tab;
 }
 
@@ -23,6 +23,7 @@
 #include "focus.h"
 #include "exec.h"
 #include "ioncore.h"
+#include "window.h"
 
 
 
@@ -229,10 +230,13 @@ void ioncore_mainloop()
         mainloop_execute_deferred();
         
         if(QLength(ioncore_g.dpy)==0){
+            /* Draw whatever the handled events have made dirty. */
+            ioncore_draw_pending();
             XSync(ioncore_g.dpy, False);
             
             if(QLength(ioncore_g.dpy)==0){
                 ioncore_flushfocus();
+                ioncore_draw_pending();
                 XSync(ioncore_g.dpy, False);
                 
                 if(QLength(ioncore_g.dpy)==0){
@@ -280,19 +280,50 @@ void ioncore_handle_mapping_notify(XEvent *ev)
 /*{{{ Expose */
 
 
+static int expose_count=0;
+
+
+/*EXTL_DOC
+ * Returns the number of \code{Expose} events received so far. This
+ * can be used to see how well the \var{save_under} and 
+ * \var{backing_store} settings (see \fnref{ioncore.set}) work.
+ */
+EXTL_SAFE
+EXTL_EXPORT
+int ioncore_expose_count()
+{
+    return expose_count;
+}
+
+
 void ioncore_handle_expose(const XExposeEvent *ev)
 {
     WWindow *wwin;
     WRootWin *rootwin;
     XEvent tmp;
+    WRectangle g;
     
-    while(XCheckWindowEvent(ioncore_g.dpy, ev->window, ExposureMask, &tmp))
-        /* nothing */;
-
     wwin=XWINDOW_REGION_OF_T(ev->window, WWindow);
-
-    if(wwin!=NULL)
-        window_draw(wwin, FALSE);
+    
+    /* Collect the exposed areas; the window is drawn once the queue
+     * has been processed.
+     */
+    while(TRUE){
+        expose_count++;
+        
+        if(wwin!=NULL){
+            g.x=ev->x;
+            g.y=ev->y;
+            g.w=ev->width;
+            g.h=ev->height;
+            window_add_damage(wwin, &g);
+        }
+        
+        if(!XCheckWindowEvent(ioncore_g.dpy, ev->window, ExposureMask, &tmp))
+            break;
+        
+        ev=&(tmp.xexpose);
+    }
 }
 
 
@@ -393,7 +424,7 @@ void ioncore_handle_focus_in(const XFocusChangeEvent *ev)
     if(ev->detail!=NotifyInferior)
         netwm_set_active(reg);
     
-    region_got_focus(reg);
+    region_schedule_got_focus(reg);
     
     if(ioncore_g.focus_next!=NULL && 
        ioncore_g.focus_next_source<IONCORE_FOCUSNEXT_FALLBACK){
@@ -444,9 +475,25 @@ void ioncore_handle_focus_out(const XFocusChangeEvent *ev)
     }
     
     if(ev->detail!=NotifyInferior)
-        region_lost_focus(reg);
+        region_schedule_lost_focus(reg);
     else
-        region_got_focus(reg);
+        region_schedule_got_focus(reg);
+}
+
+
+/* Handle the focus events at the head of the event queue. Events
+ * further back must wait for the ones before them to be handled.
+ */
+void ioncore_handle_queued_focus_events()
+{
+    XEvent ev;
+    
+    while(QLength(ioncore_g.dpy)>0){
+        XPeekEvent(ioncore_g.dpy, &ev);
+        if(ev.type!=FocusIn && ev.type!=FocusOut)
+            break;
+        ioncore_x_connection_handler(ioncore_g.conn, NULL);
+    }
 }
 
 
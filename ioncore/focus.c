@@ -6,7 +6,9 @@
  * See the included file LICENSE for details.
  */
 
+#include <libtu/objlist.h>
 #include <libmainloop/hooks.h>
+#include <libmainloop/defer.h>
 #include "common.h"
 #include "focus.h"
 #include "global.h"
@@ -16,6 +18,7 @@
 #include "activity.h"
 #include "xwindow.h"
 #include "regbind.h"
+#include "eventh.h"
 
 
 /*{{{ Hooks. */
@@ -293,6 +296,93 @@ void region_lost_focus(WRegion *reg)
 /*}}}*/
 
 
+/*{{{ Focus change accumulation */
+
+
+/* Regions with a pending focus change, in the order of the last
+ * event concerning each one. Whether the change is a gain or a loss
+ * of focus is stored in the region's REGION_FOCUS_CHANGE_GOT flag.
+ */
+static ObjList *focus_changes=NULL;
+
+
+static void apply_focus_changes(Obj *unused)
+{
+    ioncore_apply_focus_changes();
+}
+
+
+static void schedule_focus_change(WRegion *reg, bool got)
+{
+    if(reg->flags&REGION_FOCUS_CHANGE_SCHEDULED){
+        /* Already queued; only the order and direction change. */
+        objlist_reinsert_last(&focus_changes, (Obj*)reg);
+    }else{
+        if(ioncore_g.opmode==IONCORE_OPMODE_DEINIT ||
+           !mainloop_defer_action(NULL, apply_focus_changes) ||
+           !objlist_insert_last(&focus_changes, (Obj*)reg)){
+            if(got)
+                region_got_focus(reg);
+            else
+                region_lost_focus(reg);
+            return;
+        }
+        
+        reg->flags|=REGION_FOCUS_CHANGE_SCHEDULED;
+    }
+    
+    if(got)
+        reg->flags|=REGION_FOCUS_CHANGE_GOT;
+    else
+        reg->flags&=~REGION_FOCUS_CHANGE_GOT;
+}
+
+
+void region_schedule_got_focus(WRegion *reg)
+{
+    schedule_focus_change(reg, TRUE);
+}
+
+
+void region_schedule_lost_focus(WRegion *reg)
+{
+    schedule_focus_change(reg, FALSE);
+}
+
+
+/* Losses are applied before gains, so that intermediate states (a region
+ * gaining and then again losing the focus within the same batch of events)
+ * never cause activation, notification hooks or redraws.
+ */
+void ioncore_apply_focus_changes()
+{
+    ObjList *gains=NULL;
+    WRegion *reg;
+    
+    /* Fold in any focus events next in the queue. */
+    ioncore_handle_queued_focus_events();
+    
+    while((reg=(WRegion*)objlist_take_first(&focus_changes))!=NULL){
+        bool got=(reg->flags&REGION_FOCUS_CHANGE_GOT);
+        
+        reg->flags&=~(REGION_FOCUS_CHANGE_SCHEDULED|REGION_FOCUS_CHANGE_GOT);
+        
+        if(got){
+            if(!objlist_insert_last(&gains, (Obj*)reg))
+                region_got_focus(reg);
+        }else{
+            region_lost_focus(reg);
+        }
+    }
+    
+    while((reg=(WRegion*)objlist_take_first(&gains))!=NULL)
+        region_got_focus(reg);
+}
+
+
+/*}}}*/
+
+
 /*{{{ Focus status requests */
 
 
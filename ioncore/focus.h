@@ -37,6 +37,13 @@ extern WRegion *ioncore_await_focus();
 extern void region_got_focus(WRegion *reg);
 extern void region_lost_focus(WRegion *reg);
 
+/* Accumulate focus changes and apply only the net change on return to
+ * the main loop. 
+ */
+extern void region_schedule_got_focus(WRegion *reg);
+extern void region_schedule_lost_focus(WRegion *reg);
+extern void ioncore_apply_focus_changes();
+
 /* May reg transfer focus to its children? */
 extern bool region_may_control_focus(WRegion *reg);
 extern bool region_manager_is_focusnext(WRegion *reg);
@@ -340,19 +340,121 @@ void frame_recalc_bar(WFrame *frame, bool complete)
 }
 
 
-void frame_draw_bar(const WFrame *frame, bool complete)
+/* Recalculate the label of the i:th tab alone. Returns FALSE if other
+ * tabs are affected as well, and the whole bar should be recalculated.
+ */
+bool frame_recalc_tab(WFrame *frame, int i, WRegion *sub)
+{
+    int textw;
+    
+    if(frame->bar_brush==NULL || frame->titles==NULL || i>=frame->titles_n)
+        return FALSE;
+    
+    if(frame->barmode==FRAME_BAR_SHAPED){
+        int bar_w=frame->bar_w;
+        frame_shaped_recalc_bar_size(frame, FALSE);
+        if(frame->bar_w!=bar_w)
+            return FALSE;
+    }
+    
+    textw=init_title(frame, i);
+    if(textw>0)
+        frame->titles[i].text=region_make_label(sub, textw, frame->bar_brush);
+    
+    return TRUE;
+}
+
+
+void frame_mark_tab_dirty(WFrame *frame, int i)
+{
+    if(frame->titles_dirty!=NULL && i>=0 && i<frame->titles_n)
+        frame->titles_dirty[i]=TRUE;
+}
+
+
+static void frame_clear_dirty_tabs(const WFrame *frame)
+{
+    int i;
+    
+    if(frame->titles_dirty!=NULL){
+        for(i=0; i<frame->titles_n; i++)
+            frame->titles_dirty[i]=FALSE;
+    }
+}
+
+
+/* Redraw the tabs marked dirty, clipping each run of adjacent dirty tabs
+ * to its rectangle. The drawing engine skips the other tabs.
+ */
+void frame_draw_dirty_tabs(WFrame *frame)
 {
-    WRectangle geom;
+    WRectangle bg, g;
+    int i, j;
+    
+    if(frame->titles_dirty==NULL)
+        return;
     
     if(frame->bar_brush==NULL
        || !BAR_EXISTS(frame)
        || frame->titles==NULL){
+        frame_clear_dirty_tabs(frame);
         return;
     }
     
-    frame_bar_geom(frame, &geom);
+    frame_bar_geom(frame, &bg);
+    
+    for(i=0; i<frame->titles_n; i=j){
+        if(!frame->titles_dirty[i]){
+            j=i+1;
+            continue;
+        }
+        
+        g=bg;
+        g.x=bg.x+frame_nth_tab_x(frame, i);
+        g.w=0;
+        
+        for(j=i; j<frame->titles_n && frame->titles_dirty[j]; j++){
+            frame->titles_dirty[j]=FALSE;
+            g.w+=frame_nth_tab_w(frame, j);
+        }
+        
+        grbrush_begin(frame->bar_brush, &g, 
+                      GRBRUSH_AMEND|GRBRUSH_NEED_CLIP);
+        
+        grbrush_init_attr(frame->bar_brush, &frame->baseattr);
+        
+        grbrush_draw_textboxes(frame->bar_brush, &bg, frame->titles_n, 
+                               frame->titles, TRUE);
+        
+        grbrush_end(frame->bar_brush);
+    }
+}
+
 
-    grbrush_begin(frame->bar_brush, &geom, GRBRUSH_AMEND);
+/* If clip is set, only the part of the bar within it is redrawn. */
+static void frame_do_draw_bar(const WFrame *frame, bool complete,
+                              const WRectangle *clip)
+{
+    WRectangle geom, cg;
+    
+    if(frame->bar_brush==NULL
+       || !BAR_EXISTS(frame)
+       || frame->titles==NULL){
+        return;
+    }
+    
+    frame_bar_geom(frame, &geom);
+    
+    if(clip==NULL){
+        frame_clear_dirty_tabs(frame);
+        grbrush_begin(frame->bar_brush, &geom, GRBRUSH_AMEND);
+    }else{
+        cg=geom;
+        if(!rectangle_intersect(&cg, clip))
+            return;
+        grbrush_begin(frame->bar_brush, &cg, 
+                      GRBRUSH_AMEND|GRBRUSH_NEED_CLIP);
+    }
     
     grbrush_init_attr(frame->bar_brush, &frame->baseattr);
     
@@ -362,27 +464,61 @@ void frame_draw_bar(const WFrame *frame, bool complete)
     grbrush_end(frame->bar_brush);
 }
 
-void frame_draw(const WFrame *frame, bool complete)
+
+void frame_draw_bar(const WFrame *frame, bool complete)
+{
+    /* The pending redraw of the whole frame will draw the bar too. */
+    if(window_draw_is_pending((WWindow*)frame))
+        return;
+    
+    frame_do_draw_bar(frame, complete, NULL);
+}
+
+
+static void frame_do_draw(const WFrame *frame, bool complete,
+                          const WRectangle *clip)
 {
-    WRectangle geom;
+    WRectangle geom, cg;
     
     if(frame->brush==NULL)
         return;
         
     frame_border_geom(frame, &geom);
     
-    grbrush_begin(frame->brush, &geom, (complete ? 0 : GRBRUSH_NO_CLEAR_OK));
+    cg=geom;
+    
+    if(clip!=NULL && !rectangle_intersect(&cg, clip)){
+        /* Only a shaped bar outside the border can be affected. */
+        frame_do_draw_bar(frame, TRUE, clip);
+        return;
+    }
+    
+    grbrush_begin(frame->brush, &cg, 
+                  (complete ? 0 : GRBRUSH_NO_CLEAR_OK)
+                  |(clip!=NULL ? GRBRUSH_NEED_CLIP : 0));
     
     grbrush_init_attr(frame->brush, &frame->baseattr);
     
     grbrush_draw_border(frame->brush, &geom);
     
-    frame_draw_bar(frame, TRUE);
+    frame_do_draw_bar(frame, TRUE, clip);
     
     grbrush_end(frame->brush);
 }
 
 
+void frame_draw(const WFrame *frame, bool complete)
+{
+    frame_do_draw(frame, complete, NULL);
+}
+
+
+void frame_draw_clipped(WFrame *frame, const WRectangle *clip)
+{
+    frame_do_draw(frame, FALSE, clip);
+}
+
+
 void frame_brushes_updated(WFrame *frame)
 {
     WFrameBarMode barmode;
@@ -451,8 +587,45 @@ void frame_brushes_updated(WFrame *frame)
 /*{{{ Misc. */
 
 
+/* Returns TRUE if brushes looked up now would draw exactly like the 
+ * current ones. Slave brushes are used for the check, as getting a
+ * master brush changes the window background.
+ */
+static bool frame_brushes_current(WFrame *frame)
+{
+    WRootWin *rw=region_rootwin_of((WRegion*)frame);
+    GrBrush *brush, *bar_brush;
+    bool same=FALSE;
+    
+    if(frame->brush==NULL || frame->bar_brush==NULL)
+        return FALSE;
+    
+    brush=grbrush_get_slave(frame->brush, rw, 
+                            framemode_get_style(frame->mode));
+    bar_brush=grbrush_get_slave(frame->brush, rw, 
+                                framemode_get_tab_style(frame->mode));
+    
+    if(brush!=NULL && bar_brush!=NULL){
+        same=(grbrush_same_style(frame->brush, brush) &&
+              grbrush_same_style(frame->bar_brush, bar_brush));
+    }
+    
+    if(bar_brush!=NULL)
+        grbrush_release(bar_brush);
+    if(brush!=NULL)
+        grbrush_release(brush);
+    
+    return same;
+}
+
+
 void frame_updategr(WFrame *frame)
 {
+    if(frame_brushes_current(frame)){
+        region_updategr_default((WRegion*)frame);
+        return;
+    }
+    
     frame_release_brushes(frame);
     
     frame_initialise_gr(frame);
@@ -546,7 +719,7 @@ bool frame_set_background(WFrame *frame, bool set_always)
         frame->tr_mode=mode;
         if(frame->brush!=NULL){
             grbrush_enable_transparency(frame->brush, mode);
-            window_draw((WWindow*)frame, TRUE);
+            window_draw_later((WWindow*)frame, TRUE);
         }
         return TRUE;
     }
@@ -575,7 +748,7 @@ void frame_inactivated(WFrame *frame)
     gr_stylespec_set(&frame->baseattr, GR_ATTR(inactive));
     gr_stylespec_unset(&frame->baseattr, GR_ATTR(active));
 
-    window_draw((WWindow*)frame, FALSE);
+    window_draw_later((WWindow*)frame, FALSE);
 }
 
 
@@ -586,7 +759,7 @@ void frame_activated(WFrame *frame)
     gr_stylespec_set(&frame->baseattr, GR_ATTR(active));
     gr_stylespec_unset(&frame->baseattr, GR_ATTR(inactive));
     
-    window_draw((WWindow*)frame, FALSE);
+    window_draw_later((WWindow*)frame, FALSE);
 }
 
 
@@ -13,8 +13,12 @@
 #include "rectangle.h"
 
 extern void frame_draw(const WFrame *frame, bool complete);
+extern void frame_draw_clipped(WFrame *frame, const WRectangle *clip);
 extern void frame_draw_bar(const WFrame *frame, bool complete);
 extern void frame_recalc_bar(WFrame *frame, bool complete);
+extern bool frame_recalc_tab(WFrame *frame, int i, WRegion *sub);
+extern void frame_mark_tab_dirty(WFrame *frame, int i);
+extern void frame_draw_dirty_tabs(WFrame *frame);
 extern void frame_bar_geom(const WFrame *frame, WRectangle *geom);
 extern void frame_border_geom(const WFrame *frame, WRectangle *geom);
 extern void frame_border_inner_geom(const WFrame *frame, WRectangle *geom);
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <libtu/objp.h>
+#include <libmainloop/signal.h>
 
 #include "common.h"
 #include "global.h"
@@ -33,6 +34,8 @@
 
 static int p_tab_x=0, p_tab_y=0, p_tabnum=-1;
 static WInfoWin *tabdrag_infowin=NULL;
+static WTimer *tabdrag_timer=NULL;
+static Time tabdrag_moved_at=0;
 
 
 /*{{{ Frame press */
@@ -178,6 +181,64 @@ static void setup_dragwin(WFrame *frame, uint tab)
         strncpy(buf, frame->titles[tab].text, INFOWIN_BUFFER_LEN-1);
         buf[INFOWIN_BUFFER_LEN-1]='\0';
     }
+    
+    /* The tab does not change during the drag, so draw it only once. */
+    infowin_set_static(tabdrag_infowin);
+}
+
+
+static void move_dragwin()
+{
+    if(tabdrag_infowin==NULL)
+        return;
+    
+    if(REGION_GEOM(tabdrag_infowin).x==p_tab_x && 
+       REGION_GEOM(tabdrag_infowin).y==p_tab_y){
+        return;
+    }
+    
+    XMoveWindow(ioncore_g.dpy, tabdrag_infowin->wwin.win, p_tab_x, p_tab_y);
+    REGION_GEOM(tabdrag_infowin).x=p_tab_x;
+    REGION_GEOM(tabdrag_infowin).y=p_tab_y;
+}
+
+
+static void tabdrag_timer_handler(WTimer *timer, Obj *unused)
+{
+    tabdrag_moved_at+=(ioncore_g.drag_rate>0 ? 1000/ioncore_g.drag_rate : 0);
+    move_dragwin();
+}
+
+
+/* Move the drag window to follow the pointer, but at most drag_rate
+ * times per second. Positions in between are skipped; the timer makes 
+ * sure that the window ends up at the latest one.
+ */
+static void tabdrag_move(Time t)
+{
+    Time interval=(ioncore_g.drag_rate>0 ? 1000/ioncore_g.drag_rate : 0);
+    Time elapsed=t-tabdrag_moved_at;
+    
+    if(elapsed>=interval){
+        if(tabdrag_timer!=NULL)
+            timer_reset(tabdrag_timer);
+        tabdrag_moved_at=t;
+        move_dragwin();
+        return;
+    }
+    
+    if(tabdrag_timer==NULL){
+        tabdrag_timer=create_timer();
+        if(tabdrag_timer==NULL){
+            move_dragwin();
+            return;
+        }
+    }
+    
+    if(!timer_is_set(tabdrag_timer)){
+        timer_set(tabdrag_timer, interval-elapsed, 
+                  (WTimerHandler*)tabdrag_timer_handler, NULL);
+    }
 }
 
 
@@ -189,14 +250,7 @@ static void p_tabdrag_motion(WFrame *frame, XMotionEvent *ev,
     p_tab_x+=dx;
     p_tab_y+=dy;
     
-    if(tabdrag_infowin!=NULL){
-        WRectangle g;
-        g.x=p_tab_x;
-        g.y=p_tab_y;
-        g.w=REGION_GEOM(tabdrag_infowin).w;
-        g.h=REGION_GEOM(tabdrag_infowin).h;
-        region_fit((WRegion*)tabdrag_infowin, &g, REGION_FIT_EXACT);
-    }
+    tabdrag_move(ev->time);
 }
 
 
@@ -217,7 +271,11 @@ static void p_tabdrag_begin(WFrame *frame, XMotionEvent *ev,
 
     frame_draw_bar(frame, FALSE);
     
-    p_tabdrag_motion(frame, ev, dx, dy);
+    p_tab_x+=dx;
+    p_tab_y+=dy;
+    
+    tabdrag_moved_at=ev->time;
+    move_dragwin();
     
     if(tabdrag_infowin!=NULL)
         window_map((WWindow*)tabdrag_infowin);
@@ -287,6 +345,12 @@ static void tabdrag_deinit(WFrame *frame)
     frame->tab_dragged_idx=-1;
     frame_update_attr_nth(frame, idx);
     
+    if(tabdrag_timer!=NULL){
+        timer_reset(tabdrag_timer);
+        destroy_obj((Obj*)tabdrag_timer);
+        tabdrag_timer=NULL;
+    }
+    
     if(tabdrag_infowin!=NULL){
         destroy_obj((Obj*)tabdrag_infowin);
         tabdrag_infowin=NULL;
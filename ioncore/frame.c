@@ -94,6 +94,7 @@ bool frame_init(WFrame *frame, WWindow *parent, const WFitParams *fp,
     frame->tab_dragged_idx=-1;
     frame->titles=NULL;
     frame->titles_n=0;
+    frame->titles_dirty=NULL;
     frame->bar_h=0;
     frame->bar_w=fp->g.w;
     frame->tr_mode=GR_TRANSPARENCY_DEFAULT;
@@ -340,6 +341,22 @@ void frame_update_attr_nth(WFrame *frame, int i)
 }
 
 
+static int frame_tab_index(WFrame *frame, WRegion *reg)
+{
+    int i=0;
+    WRegion *sub;
+    WLListIterTmp tmp;
+    
+    FRAME_MX_FOR_ALL(sub, frame, tmp){
+        if(sub==reg)
+            return i;
+        i++;
+    }
+    
+    return -1;
+}
+
+
 static void frame_update_attrs(WFrame *frame)
 {
     int i=0;
@@ -366,6 +383,10 @@ static void frame_free_titles(WFrame *frame)
         free(frame->titles);
         frame->titles=NULL;
     }
+    if(frame->titles_dirty!=NULL){
+        free(frame->titles_dirty);
+        frame->titles_dirty=NULL;
+    }
     frame->titles_n=0;
 }
 
@@ -395,6 +416,9 @@ static bool frame_initialise_titles(WFrame *frame)
         return FALSE;
     frame->titles_n=n;
     
+    /* Without it, every change simply redraws the whole bar. */
+    frame->titles_dirty=ALLOC_N(bool, n);
+    
     if(FRAME_MCOUNT(frame)==0){
         do_init_title(frame, 0, NULL);
     }else{
@@ -759,7 +783,7 @@ bool frame_set_grattr(WFrame *frame, GrAttr a, int sp)
             gr_stylespec_set(&frame->baseattr, a);
         else
             gr_stylespec_unset(&frame->baseattr, a);
-        window_draw((WWindow*)frame, TRUE);
+        window_draw_later((WWindow*)frame, TRUE);
     }
     
     return nset;
@@ -793,7 +817,20 @@ void frame_managed_notify(WFrame *frame, WRegion *sub, WRegionNotify how)
        how==ioncore_g.notifies.activity ||
        how==ioncore_g.notifies.sub_activity ||
        how==ioncore_g.notifies.tag){
-       
+        
+        int i=frame_tab_index(frame, sub);
+        
+        /* Only the tab of sub is affected, unless a shaped bar has 
+         * to change its width. */
+        if(i>=0 && frame->titles_dirty!=NULL && i<frame->titles_n){
+            frame_update_attr(frame, i, sub);
+            if(frame_recalc_tab(frame, i, sub)){
+                frame_mark_tab_dirty(frame, i);
+                frame_draw_dirty_tabs(frame);
+                return;
+            }
+        }
+        
         frame_update_attrs(frame);
         frame_recalc_bar(frame, FALSE);
         frame_draw_bar(frame, FALSE);
@@ -993,6 +1030,9 @@ static DynFunTab frame_dynfuntab[]={
     {window_draw, 
      frame_draw},
     
+    {window_draw_clipped, 
+     frame_draw_clipped},
+    
     {mplex_managed_geom, 
      frame_managed_geom},
 
@@ -71,6 +71,7 @@ DECLCLASS(WFrame){
     GrTransparency tr_mode;
     GrTextElem *titles;
     int titles_n;
+    bool *titles_dirty;
     
     /* Bar stuff */
     WFrameBarMode barmode;
@@ -65,6 +65,7 @@ DECLSTRUCT(WGlobal){
     Atom atom_selection;
     Atom atom_mwm_hints;
     Atom atom_dockapp_hack;
+    Atom atom_utf8_string;
     
     WRootWin *rootwins;
     WScreen *screens;
@@ -82,6 +83,7 @@ DECLSTRUCT(WGlobal){
     
     Time dblclick_delay;
     int opaque_resize;
+    bool xor_rubberband;
     bool warp_enabled;
     bool switchto_new;
     bool screen_notify;
@@ -90,6 +92,7 @@ DECLSTRUCT(WGlobal){
     bool no_mousefocus;
     bool unsqueeze_enabled;
     bool autoraise;
+    int drag_rate;
     
     bool use_mb; /* use mb routines? */
     bool enc_sb; /* 8-bit charset? If unset, use_mb must be set. */
@@ -16,6 +16,7 @@
 #include "global.h"
 #include "modules.h"
 #include "gr.h"
+#include "strings.h"
 
 
 /*{{{ Lookup and registration */
@@ -142,6 +143,52 @@ GrBrush *gr_get_brush(Window win, WRootWin *rootwin, const char *style)
 /*}}}*/
 
 
+/*{{{ Attribute bits */
+
+
+#define BIT_WORD(B) ((B)/GR_STYLESPEC_WORD_BITS)
+#define BIT_MASK(B) (1UL<<((B)%GR_STYLESPEC_WORD_BITS))
+
+#define BIT_ISSET(S, B) (((S)->bits[BIT_WORD(B)]&BIT_MASK(B))!=0)
+#define BIT_SET(S, B) ((S)->bits[BIT_WORD(B)]|=BIT_MASK(B))
+#define BIT_CLEAR(S, B) ((S)->bits[BIT_WORD(B)]&=~BIT_MASK(B))
+
+#define ATTR_HASH_SIZE (2*GR_STYLESPEC_NBITS)
+
+
+/* Open addressing hash from attribute to bit. Attributes that have been
+ * assigned a bit are referenced for good, so that their ids are not
+ * reused for other strings.
+ */
+static GrAttr bit_attrs[ATTR_HASH_SIZE];
+static int bit_index[ATTR_HASH_SIZE];
+static uint bit_count=0;
+
+
+static int attr_bit(GrAttr a, bool alloc)
+{
+    uint h=(uint)(((ulong)a>>3)*2654435761u>>8)&(ATTR_HASH_SIZE-1);
+    
+    while(bit_attrs[h]!=GRATTR_NONE){
+        if(bit_attrs[h]==a)
+            return bit_index[h];
+        h=(h+1)&(ATTR_HASH_SIZE-1);
+    }
+    
+    if(!alloc || bit_count>=GR_STYLESPEC_NBITS)
+        return -1;
+    
+    stringstore_ref(a);
+    bit_attrs[h]=a;
+    bit_index[h]=bit_count++;
+    
+    return bit_index[h];
+}
+
+
+/*}}}*/
+
+
 /*{{{ Scoring */
 
 
@@ -185,6 +232,26 @@ uint gr_stylespec_score2(const GrStyleSpec *spec, const GrStyleSpec *attr1,
 {
     uint score=0;
     uint i;
+    int star_bit;
+    
+    if(star_id==STRINGID_NONE)
+        star_id=stringstore_alloc("*");
+    
+    star_bit=attr_bit(star_id, FALSE);
+    
+    /* Any attribute of spec, other than the star, not set in either 
+     * attribute set forces the score to zero. 
+     */
+    for(i=0; i<GR_STYLESPEC_WORDS; i++){
+        ulong avail=attr1->bits[i]|(attr2!=NULL ? attr2->bits[i] : 0);
+        ulong need=spec->bits[i];
+        
+        if(star_bit>=0 && BIT_WORD(star_bit)==i)
+            need&=~BIT_MASK(star_bit);
+        
+        if(need&~avail)
+            return 0;
+    }
     
     for(i=0; i<spec->n; i++){
         int sc=scorefind(attr1, &spec->attrs[i]);
@@ -273,6 +340,17 @@ bool gr_stylespec_load(GrStyleSpec *spec, const char *str)
 }
 
 
+static void clear_bits(GrStyleSpec *spec)
+{
+    uint i;
+    
+    for(i=0; i<GR_STYLESPEC_WORDS; i++)
+        spec->bits[i]=0;
+    
+    spec->nbitless=0;
+}
+
+
 void gr_stylespec_unalloc(GrStyleSpec *spec)
 {
     uint i;
@@ -286,6 +364,7 @@ void gr_stylespec_unalloc(GrStyleSpec *spec)
     }
     
     spec->n=0;
+    clear_bits(spec);
 }
 
 
@@ -293,6 +372,7 @@ void gr_stylespec_init(GrStyleSpec *spec)
 {
     spec->attrs=NULL;
     spec->n=0;
+    clear_bits(spec);
 }
 
 
@@ -316,6 +396,13 @@ static bool gr_stylespec_find_(const GrStyleSpec *spec, GrAttr a, int *idx_ge)
 bool gr_stylespec_isset(const GrStyleSpec *spec, GrAttr a)
 {
     int idx_ge;
+    int bit=attr_bit(a, FALSE);
+    
+    if(bit>=0)
+        return BIT_ISSET(spec, bit);
+    
+    if(spec->nbitless==0)
+        return FALSE;
     
     return gr_stylespec_find_(spec, a, &idx_ge);
 }
@@ -326,10 +413,13 @@ bool gr_stylespec_add(GrStyleSpec *spec, GrAttr a, uint score)
     static const uint sz=sizeof(GrAttrScore);
     GrAttrScore *idsn;
     int idx_ge;
+    int bit;
     
     if(a==GRATTR_NONE || score==0)
         return TRUE;
     
+    bit=attr_bit(a, TRUE);
+    
     if(gr_stylespec_find_(spec, a, &idx_ge)){
         spec->attrs[idx_ge].score+=score;
         return TRUE;
@@ -349,6 +439,11 @@ bool gr_stylespec_add(GrStyleSpec *spec, GrAttr a, uint score)
     spec->attrs=idsn;
     spec->n++;
     
+    if(bit>=0)
+        BIT_SET(spec, bit);
+    else
+        spec->nbitless++;
+    
     return TRUE;
 }
 
@@ -364,13 +459,27 @@ void gr_stylespec_unset(GrStyleSpec *spec, GrAttr a)
     static const uint sz=sizeof(GrAttrScore);
     GrAttrScore *idsn;
     int idx_ge;
+    int bit;
     
     if(a==GRATTR_NONE)
         return;
     
+    bit=attr_bit(a, FALSE);
+    
+    if(bit>=0){
+        if(!BIT_ISSET(spec, bit))
+            return;
+        BIT_CLEAR(spec, bit);
+    }else if(spec->nbitless==0){
+        return;
+    }
+    
     if(!gr_stylespec_find_(spec, a, &idx_ge))
         return;
     
+    if(bit<0)
+        spec->nbitless--;
+    
     stringstore_free(spec->attrs[idx_ge].attr);
     
     memmove(spec->attrs+idx_ge, spec->attrs+idx_ge+1,
@@ -404,6 +513,10 @@ static bool gr_stylespec_do_init_from(GrStyleSpec *dst, const GrStyleSpec *src)
     
     dst->n=src->n;
     
+    for(i=0; i<GR_STYLESPEC_WORDS; i++)
+        dst->bits[i]=src->bits[i];
+    dst->nbitless=src->nbitless;
+    
     return TRUE;
 }
 
@@ -432,6 +545,14 @@ bool gr_stylespec_equals(const GrStyleSpec *s1, const GrStyleSpec *s2)
     
     if(s1->n!=s2->n)
         return FALSE;
+    
+    for(i=0; i<GR_STYLESPEC_WORDS; i++){
+        if(s1->bits[i]!=s2->bits[i])
+            return FALSE;
+    }
+    
+    if(s1->nbitless==0)
+        return TRUE;
         
     for(i=0; i<s1->n; i++){
         if(s1->attrs[i].attr!=s2->attrs[i].attr)
@@ -456,6 +577,7 @@ bool grbrush_init(GrBrush *brush)
 
 void grbrush_deinit(GrBrush *brush)
 {
+    grbrush_flush_labels(brush);
 }
 
 
@@ -493,6 +615,20 @@ void grbrush_end(GrBrush *brush)
 }
 
 
+Pixmap grbrush_end_pixmap(GrBrush *brush)
+{
+    Pixmap ret=None;
+    
+    if(!HAS_DYN(brush, grbrush_end_pixmap)){
+        grbrush_end(brush);
+        return None;
+    }
+    
+    CALL_DYN_RET(ret, Pixmap, grbrush_end_pixmap, brush, (brush));
+    return ret;
+}
+
+
 /*}}}*/
 
 
@@ -521,6 +657,14 @@ DYNFUN bool grbrush_get_extra(GrBrush *brush, const char *key,
 }
 
 
+DYNFUN bool grbrush_same_style(GrBrush *brush, GrBrush *other)
+{
+    bool ret=FALSE;
+    CALL_DYN_RET(ret, bool, grbrush_same_style, brush, (brush, other));
+    return ret;
+}
+
+
 /*}}}*/
 
 
@@ -643,6 +787,8 @@ void grbrush_unset_attr(GrBrush *brush, GrAttr attr)
 EXTL_EXPORT_AS(gr, read_config)
 void gr_read_config()
 {
+    ioncore_flush_labels();
+    
     extl_read_config("look", NULL, TRUE);
     
     /* If nothing has been loaded, try the default engine with
@@ -663,6 +809,8 @@ void gr_refresh()
 {
     WRootWin *rootwin;
     
+    ioncore_flush_labels();
+    
     FOR_ALL_ROOTWINS(rootwin){
         region_updategr((WRegion*)rootwin);
     }
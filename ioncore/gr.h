@@ -45,7 +45,15 @@ typedef StringId GrAttr;
 
 #define GRATTR_NONE STRINGID_NONE
 
-#define GR_STYLESPEC_INIT {0, NULL}
+#define GR_STYLESPEC_INIT {0, NULL, {0}, 0}
+
+/* Attributes are assigned bits on first use. The bits of a spec mirror
+ * its attribute list, except for attributes that did not fit in the
+ * bitset, which are counted in nbitless.
+ */
+#define GR_STYLESPEC_WORDS 2
+#define GR_STYLESPEC_WORD_BITS (sizeof(ulong)*8)
+#define GR_STYLESPEC_NBITS (GR_STYLESPEC_WORDS*GR_STYLESPEC_WORD_BITS)
 
 typedef struct{
     GrAttr attr;
@@ -55,6 +63,8 @@ typedef struct{
 typedef struct{
     uint n;
     GrAttrScore *attrs;
+    ulong bits[GR_STYLESPEC_WORDS];
+    uint nbitless;
 } GrStyleSpec;
 
 #define GR_TEXTELEM_INIT {NULL, 0, GR_STYLESPEC_INIT}
@@ -84,6 +94,7 @@ typedef enum{
 #define GRBRUSH_NEED_CLIP   0x0004
 #define GRBRUSH_NO_CLEAR_OK 0x0008 /* implied by GRBRUSH_AMEND */
 #define GRBRUSH_KEEP_ATTR   0x0010
+#define GRBRUSH_OFFSCREEN   0x0020 /* see grbrush_end_pixmap */
 
 /* Engines etc. */
 
@@ -133,6 +144,12 @@ extern void grbrush_deinit(GrBrush *brush);
 DYNFUN void grbrush_begin(GrBrush *brush, const WRectangle *geom,
                           int flags);
 DYNFUN void grbrush_end(GrBrush *brush);
+/* Ends drawing begun with GRBRUSH_OFFSCREEN. The result is returned as a
+ * new pixmap, of at least the size of the area drawn, and the window is 
+ * left untouched. If the engine can't do this, the drawing has gone to
+ * the window as usual, and None is returned.
+ */
+DYNFUN Pixmap grbrush_end_pixmap(GrBrush *brush);
 
 /* Attributes */
 
@@ -184,4 +201,7 @@ DYNFUN void grbrush_clear_area(GrBrush *brush, const WRectangle *geom);
 DYNFUN bool grbrush_get_extra(GrBrush *brush, const char *key, 
                               char type, void *data);
 
+/* Returns TRUE if other would draw exactly like brush. */
+DYNFUN bool grbrush_same_style(GrBrush *brush, GrBrush *other);
+
 #endif /* ION_IONCORE_GR_H */
@@ -25,8 +25,6 @@
 bool infowin_init(WInfoWin *p, WWindow *parent, const WFitParams *fp,
                   const char *style)
 {
-    XSetWindowAttributes attr;
-    
     if(!window_init(&(p->wwin), parent, fp))
         return FALSE;
     
@@ -43,6 +41,7 @@ bool infowin_init(WInfoWin *p, WWindow *parent, const WFitParams *fp,
         goto fail2;
     
     p->brush=NULL;
+    p->static_bg=FALSE;
     
     gr_stylespec_init(&p->attr);
     
@@ -51,10 +50,6 @@ bool infowin_init(WInfoWin *p, WWindow *parent, const WFitParams *fp,
     if(p->brush==NULL)
         goto fail3;
     
-    /* Enable save unders */
-    attr.save_under=True;
-    XChangeWindowAttributes(ioncore_g.dpy, p->wwin.win, CWSaveUnder, &attr);
-    
     window_select_input(&(p->wwin), IONCORE_EVENTMASK_NORMAL);
 
     return TRUE;
@@ -110,7 +105,8 @@ void infowin_draw(WInfoWin *p, bool complete)
 {
     WRectangle g;
     
-    if(p->brush==NULL)
+    /* With a static background, the server does the drawing. */
+    if(p->brush==NULL || p->static_bg)
         return;
     
     g.x=0;
@@ -141,8 +137,54 @@ void infowin_updategr(WInfoWin *p)
         grbrush_release(p->brush);
     
     p->brush=nbrush;
+    p->static_bg=FALSE;
+    
+    window_draw_later(&(p->wwin), TRUE);
+}
+
+
+/* Render the contents of the window once into a pixmap, and make that
+ * the background of the window, so that moving it around or exposing
+ * it requires no drawing. Returns FALSE if the drawing engine can not
+ * do this; the window is then drawn normally.
+ */
+bool infowin_set_static(WInfoWin *p)
+{
+    WRectangle g;
+    Pixmap pixmap;
+    
+    if(p->brush==NULL)
+        return FALSE;
+    
+    g.x=0;
+    g.y=0;
+    g.w=REGION_GEOM(p).w;
+    g.h=REGION_GEOM(p).h;
+    
+    grbrush_begin(p->brush, &g, GRBRUSH_OFFSCREEN);
+    grbrush_init_attr(p->brush, &p->attr);
+    grbrush_draw_textbox(p->brush, &g, p->buffer, TRUE);
+    pixmap=grbrush_end_pixmap(p->brush);
+    
+    if(pixmap==None)
+        return FALSE;
+    
+    XSetWindowBackgroundPixmap(ioncore_g.dpy, p->wwin.win, pixmap);
+    XClearWindow(ioncore_g.dpy, p->wwin.win);
+    XFreePixmap(ioncore_g.dpy, pixmap);
     
-    window_draw(&(p->wwin), TRUE);
+    p->static_bg=TRUE;
+    
+    return TRUE;
+}
+
+
+static void infowin_unset_static(WInfoWin *p)
+{
+    if(p->static_bg){
+        p->static_bg=FALSE;
+        grbrush_enable_transparency(p->brush, GR_TRANSPARENCY_DEFAULT);
+    }
 }
 
 
@@ -198,6 +240,8 @@ void infowin_set_text(WInfoWin *p, const char *str, int maxw)
 {
     bool set=FALSE;
     
+    infowin_unset_static(p);
+    
     if(str==NULL){
         INFOWIN_BUFFER(p)[0]='\0';
     }else{
@@ -217,7 +261,7 @@ void infowin_set_text(WInfoWin *p, const char *str, int maxw)
     infowin_resize(p);
     
     /* sometimes unnecessary */
-    window_draw((WWindow*)p, TRUE);
+    window_draw_later((WWindow*)p, TRUE);
 }
 
 
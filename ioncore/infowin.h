@@ -22,6 +22,7 @@ DECLCLASS(WInfoWin){
     char *buffer;
     char *style;
     GrStyleSpec attr;
+    bool static_bg;
 };
 
 #define INFOWIN_BRUSH(INFOWIN) ((INFOWIN)->brush)
@@ -36,6 +37,7 @@ extern void infowin_deinit(WInfoWin *p);
 
 extern void infowin_set_text(WInfoWin *p, const char *s, int maxw);
 extern GrStyleSpec *infowin_stylespec(WInfoWin *p);
+extern bool infowin_set_static(WInfoWin *p);
 
 extern WRegion *infowin_load(WWindow *par, const WFitParams *fp, ExtlTab tab);
 
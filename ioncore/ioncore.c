@@ -59,6 +59,7 @@
 #include "llist.h"
 #include "exec.h"
 #include "screen-notify.h"
+#include "backing.h"
 #include "key.h"
 
 
@@ -353,11 +354,13 @@ static bool init_global()
     ioncore_g.opmode=IONCORE_OPMODE_INIT;
     ioncore_g.dblclick_delay=CF_DBLCLICK_DELAY;
     ioncore_g.opaque_resize=0;
+    ioncore_g.xor_rubberband=FALSE;
     ioncore_g.warp_enabled=TRUE;
     ioncore_g.switchto_new=TRUE;
     ioncore_g.no_mousefocus=FALSE;
     ioncore_g.unsqueeze_enabled=TRUE;
     ioncore_g.autoraise=TRUE;
+    ioncore_g.drag_rate=CF_DRAG_RATE;
     
     ioncore_g.enc_utf8=FALSE;
     ioncore_g.enc_sb=TRUE;
@@ -525,6 +528,7 @@ static bool ioncore_init_x(const char *display, int stflags)
     ioncore_g.atom_selection=XInternAtom(dpy, "_ION_SELECTION_STRING", False);
     ioncore_g.atom_dockapp_hack=XInternAtom(dpy, "_ION_DOCKAPP_HACK", False);
     ioncore_g.atom_mwm_hints=XInternAtom(dpy, "_MOTIF_WM_HINTS", False);
+    ioncore_g.atom_utf8_string=XInternAtom(dpy, "UTF8_STRING", False);
 
     ioncore_init_xim();
     ioncore_init_bindings();
@@ -648,6 +652,8 @@ void ioncore_deinit()
         destroy_obj((Obj*)ioncore_g.rootwins);
 
     ioncore_deinit_bindmaps();
+    
+    ioncore_backing_deinit();
 
     mainloop_unregister_input_fd(ioncore_g.conn);
     
@@ -35,6 +35,7 @@ static long actmax=200, uptmin=50;
 static int resize_delay=CF_RESIZE_DELAY;
 /* Here to not have to write other set callback for resize code... */
 int ioncore_edge_resistance=CF_EDGE_RESISTANCE;
+int ioncore_moveres_rate=CF_MOVERES_RATE;
 
 
 static void accel_reset()
@@ -63,6 +64,8 @@ void ioncore_set_moveres_accel(ExtlTab tab)
         resize_delay=maxof(0, rd);
     if(extl_table_gets_i(tab, "edge_resistance", &er))
         ioncore_edge_resistance=maxof(0, er);
+    if(extl_table_gets_i(tab, "moveres_rate", &er))
+        ioncore_moveres_rate=maxof(0, er);
 }
 
 
@@ -74,6 +77,7 @@ void ioncore_get_moveres_accel(ExtlTab tab)
     extl_table_sets_d(tab, "kbresize_maxacc", accelmax);
     extl_table_sets_d(tab, "kbresize_delay", resize_delay);
     extl_table_sets_i(tab, "edge_resistance", ioncore_edge_resistance);
+    extl_table_sets_i(tab, "moveres_rate", ioncore_moveres_rate);
 }
 
 
@@ -8,8 +8,12 @@
 
 #include <X11/Xatom.h>
 #include <X11/Xmd.h>
+#include <string.h>
 
 #include <libtu/util.h>
+#include <libtu/misc.h>
+#include <libtu/minmax.h>
+#include <libmainloop/defer.h>
 #include "common.h"
 #include "global.h"
 #include "fullscreen.h"
@@ -30,8 +34,10 @@ static Atom atom_net_wm_state_fullscreen=0;
 static Atom atom_net_supporting_wm_check=0;
 static Atom atom_net_virtual_roots=0;
 static Atom atom_net_active_window=0;
+static Atom atom_net_client_list=0;
+static Atom atom_net_client_list_stacking=0;
 
-#define N_NETWM 6
+#define N_NETWM 8
 
 static Atom atom_net_supported=0;
 
@@ -41,6 +47,10 @@ static Atom atom_net_supported=0;
 /*{{{ Initialisation */
 
 
+static void netwm_schedule_client_list_update(WRootWin *rw);
+
+
+
 void netwm_init()
 {
     atom_net_wm_name=XInternAtom(ioncore_g.dpy, "_NET_WM_NAME", False);
@@ -50,6 +60,8 @@ void netwm_init()
     atom_net_supporting_wm_check=XInternAtom(ioncore_g.dpy, "_NET_SUPPORTING_WM_CHECK", False);
     atom_net_virtual_roots=XInternAtom(ioncore_g.dpy, "_NET_VIRTUAL_ROOTS", False);
     atom_net_active_window=XInternAtom(ioncore_g.dpy, "_NET_ACTIVE_WINDOW", False);
+    atom_net_client_list=XInternAtom(ioncore_g.dpy, "_NET_CLIENT_LIST", False);
+    atom_net_client_list_stacking=XInternAtom(ioncore_g.dpy, "_NET_CLIENT_LIST_STACKING", False);
 }
 
 
@@ -64,6 +76,8 @@ void netwm_init_rootwin(WRootWin *rw)
     atoms[3]=atom_net_supporting_wm_check;
     atoms[4]=atom_net_virtual_roots;
     atoms[5]=atom_net_active_window;
+    atoms[6]=atom_net_client_list;
+    atoms[7]=atom_net_client_list_stacking;
     
     XChangeProperty(ioncore_g.dpy, WROOTWIN_ROOT(rw),
                     atom_net_supporting_wm_check, XA_WINDOW,
@@ -74,6 +88,29 @@ void netwm_init_rootwin(WRootWin *rw)
 
     p[0]=libtu_progbasename();
     xwindow_set_text_property(rw->dummy_win, atom_net_wm_name, p, 1);
+    
+    /* Replace whatever a previous window manager may have left in the
+     * client lists with the windows managed so far.
+     */
+    netwm_schedule_client_list_update(rw);
+}
+
+
+void netwm_deinit_rootwin(WRootWin *rw)
+{
+    XDeleteProperty(ioncore_g.dpy, WROOTWIN_ROOT(rw), atom_net_client_list);
+    XDeleteProperty(ioncore_g.dpy, WROOTWIN_ROOT(rw), 
+                    atom_net_client_list_stacking);
+    
+    if(rw->net_client_list!=NULL)
+        free(rw->net_client_list);
+    if(rw->net_client_list_stacking!=NULL)
+        free(rw->net_client_list_stacking);
+    
+    rw->net_client_list=NULL;
+    rw->net_client_list_stacking=NULL;
+    rw->net_client_list_n=0;
+    rw->net_client_list_alloc=0;
 }
 
 
@@ -202,6 +239,186 @@ static void netwm_active_window_rq(WClientWin *cwin,
 /*}}}*/
 
 
+/*{{{ _NET_CLIENT_LIST, _NET_CLIENT_LIST_STACKING */
+
+
+static void set_client_list_property(WRootWin *rw, Atom a, 
+                                     WClientWin **list, Window *tmp)
+{
+    int i, n=rw->net_client_list_n;
+    
+    for(i=0; i<n; i++)
+        tmp[i]=list[i]->win;
+    
+    XChangeProperty(ioncore_g.dpy, WROOTWIN_ROOT(rw), a, XA_WINDOW, 
+                    32, PropModeReplace, (uchar*)tmp, n);
+}
+
+
+static void netwm_do_update_client_list(WRootWin *rw)
+{
+    Window *tmp;
+    
+    rw->net_client_list_scheduled=FALSE;
+    
+    tmp=ALLOC_N(Window, maxof(rw->net_client_list_n, 1));
+    if(tmp==NULL)
+        return;
+    
+    set_client_list_property(rw, atom_net_client_list, 
+                             rw->net_client_list, tmp);
+    set_client_list_property(rw, atom_net_client_list_stacking, 
+                             rw->net_client_list_stacking, tmp);
+    
+    free(tmp);
+}
+
+
+/* Complete rewrites of the properties are delayed until we return to 
+ * the main loop, so that e.g. closing a group of windows or a series of
+ * raises results in just one update.
+ */
+static void netwm_schedule_client_list_update(WRootWin *rw)
+{
+    if(rw->net_client_list_scheduled || 
+       ioncore_g.opmode==IONCORE_OPMODE_DEINIT){
+        return;
+    }
+    
+    if(mainloop_defer_action((Obj*)rw, 
+                             (WDeferredAction*)netwm_do_update_client_list)){
+        rw->net_client_list_scheduled=TRUE;
+    }else{
+        netwm_do_update_client_list(rw);
+    }
+}
+
+
+static int client_list_find(WClientWin **list, int n, WClientWin *cwin)
+{
+    int i;
+    
+    for(i=n-1; i>=0; i--){
+        if(list[i]==cwin)
+            break;
+    }
+    
+    return i;
+}
+
+
+static void client_list_take(WClientWin **list, int n, int i)
+{
+    memmove(list+i, list+i+1, (n-i-1)*sizeof(WClientWin*));
+}
+
+
+static bool client_list_grow(WRootWin *rw)
+{
+    int n=rw->net_client_list_alloc;
+    int n2=maxof(2*n, 16);
+    WClientWin **l, **s;
+    
+    l=REALLOC_N(rw->net_client_list, WClientWin*, n, n2);
+    if(l==NULL)
+        return FALSE;
+    rw->net_client_list=l;
+    
+    s=REALLOC_N(rw->net_client_list_stacking, WClientWin*, n, n2);
+    if(s==NULL)
+        return FALSE;
+    rw->net_client_list_stacking=s;
+    
+    rw->net_client_list_alloc=n2;
+    
+    return TRUE;
+}
+
+
+void netwm_client_list_add(WClientWin *cwin)
+{
+    WRootWin *rw=region_rootwin_of((WRegion*)cwin);
+    Window win=cwin->win;
+    int n;
+    
+    if(rw==NULL || win==None)
+        return;
+    
+    n=rw->net_client_list_n;
+    
+    if(n==rw->net_client_list_alloc && !client_list_grow(rw))
+        return;
+    
+    rw->net_client_list[n]=cwin;
+    rw->net_client_list_stacking[n]=cwin;
+    rw->net_client_list_n=n+1;
+    
+    /* New windows go at the end of both lists, so unless a complete
+     * rewrite is already pending, just append them.
+     */
+    if(rw->net_client_list_scheduled || 
+       ioncore_g.opmode==IONCORE_OPMODE_DEINIT){
+        return;
+    }
+    
+    XChangeProperty(ioncore_g.dpy, WROOTWIN_ROOT(rw), 
+                    atom_net_client_list, XA_WINDOW, 
+                    32, PropModeAppend, (uchar*)&win, 1);
+    XChangeProperty(ioncore_g.dpy, WROOTWIN_ROOT(rw), 
+                    atom_net_client_list_stacking, XA_WINDOW, 
+                    32, PropModeAppend, (uchar*)&win, 1);
+}
+
+
+void netwm_client_list_remove(WClientWin *cwin)
+{
+    WRootWin *rw=region_rootwin_of((WRegion*)cwin);
+    int i, n;
+    
+    if(rw==NULL)
+        return;
+    
+    n=rw->net_client_list_n;
+    
+    i=client_list_find(rw->net_client_list, n, cwin);
+    if(i<0)
+        return;
+    client_list_take(rw->net_client_list, n, i);
+    
+    i=client_list_find(rw->net_client_list_stacking, n, cwin);
+    if(i>=0)
+        client_list_take(rw->net_client_list_stacking, n, i);
+    
+    rw->net_client_list_n=n-1;
+    
+    netwm_schedule_client_list_update(rw);
+}
+
+
+void netwm_client_list_raise(WClientWin *cwin)
+{
+    WRootWin *rw=region_rootwin_of((WRegion*)cwin);
+    int i, n;
+    
+    if(rw==NULL)
+        return;
+    
+    n=rw->net_client_list_n;
+    
+    i=client_list_find(rw->net_client_list_stacking, n, cwin);
+    if(i<0 || i==n-1)
+        return;
+    
+    client_list_take(rw->net_client_list_stacking, n, i);
+    rw->net_client_list_stacking[n-1]=cwin;
+    
+    netwm_schedule_client_list_update(rw);
+}
+
+
+/*}}}*/
+
+
 /*{{{ _NET_WM_NAME */
 
 
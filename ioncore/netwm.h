@@ -19,6 +19,7 @@
 
 extern void netwm_init();
 extern void netwm_init_rootwin(WRootWin *rw);
+extern void netwm_deinit_rootwin(WRootWin *rw);
 
 extern WScreen *netwm_check_initial_fullscreen(WClientWin *cwin);
 extern void netwm_update_state(WClientWin *cwin);
@@ -26,6 +27,10 @@ extern void netwm_delete_state(WClientWin *cwin);
 extern void netwm_set_active(WRegion *reg);
 extern char **netwm_get_name(WClientWin *cwin);
 
+extern void netwm_client_list_add(WClientWin *cwin);
+extern void netwm_client_list_remove(WClientWin *cwin);
+extern void netwm_client_list_raise(WClientWin *cwin);
+
 extern void netwm_handle_client_message(const XClientMessageEvent *ev);
 extern bool netwm_handle_property(WClientWin *cwin, const XPropertyEvent *ev);
 
@@ -164,11 +164,101 @@ void xwindow_set_state_property(Window win, int state)
 /*{{{ Text property stuff */
 
 
+enum{
+    TEXTPROP_CONVERT,
+    TEXTPROP_COPY,
+    TEXTPROP_LATIN1_TO_UTF8
+};
+
+
+static int text_property_decode_mode(const XTextProperty *prop)
+{
+    bool ascii=TRUE;
+    ulong i;
+    
+    if(prop->format!=8)
+        return TEXTPROP_CONVERT;
+    
+    for(i=0; i<prop->nitems; i++){
+        if(prop->value[i]&0x80){
+            ascii=FALSE;
+            break;
+        }
+    }
+    
+    if(prop->encoding==XA_STRING){
+        if(!ioncore_g.use_mb || ascii)
+            return TEXTPROP_COPY;
+        if(ioncore_g.enc_utf8)
+            return TEXTPROP_LATIN1_TO_UTF8;
+    }else if(prop->encoding==ioncore_g.atom_utf8_string){
+        if(ioncore_g.use_mb && (ioncore_g.enc_utf8 || ascii))
+            return TEXTPROP_COPY;
+    }
+    
+    return TEXTPROP_CONVERT;
+}
+
+
+/* Split the NUL-separated property data into a list laid out the way
+ * XTextPropertyToStringList does it (all strings in one buffer pointed
+ * to by the first element), so that XFreeStringList still applies.
+ */
+static char **text_property_split(const XTextProperty *prop, int mode, 
+                                  int *nret)
+{
+    char **list;
+    char *buf, *d;
+    ulong i;
+    int n=1, j;
+    
+    for(i=0; i<prop->nitems; i++){
+        if(prop->value[i]=='\0')
+            n++;
+    }
+    
+    list=ALLOC_N(char*, n+1);
+    if(list==NULL)
+        return NULL;
+    
+    buf=ALLOC_N(char, (mode==TEXTPROP_LATIN1_TO_UTF8 ? 2 : 1)*prop->nitems+1);
+    if(buf==NULL){
+        free(list);
+        return NULL;
+    }
+    
+    d=buf;
+    list[0]=d;
+    j=1;
+    
+    for(i=0; i<prop->nitems; i++){
+        uchar c=prop->value[i];
+        
+        if(c=='\0'){
+            *d++='\0';
+            list[j++]=d;
+        }else if(c<0x80 || mode==TEXTPROP_COPY){
+            *d++=c;
+        }else{
+            *d++=0xC0|(c>>6);
+            *d++=0x80|(c&0x3F);
+        }
+    }
+    
+    *d='\0';
+    list[n]=NULL;
+    *nret=n;
+    
+    return list;
+}
+
+
 char **xwindow_get_text_property(Window win, Atom a, int *nret)
 {
     XTextProperty prop;
     char **list=NULL;
     int n=0;
+    int mode;
     Status st;
     bool ok;
     
@@ -189,7 +279,14 @@ char **xwindow_get_text_property(Window win, Atom a, int *nret)
     }
 #endif
 
-    if(!ioncore_g.use_mb){
+    mode=text_property_decode_mode(&prop);
+    
+    if(mode!=TEXTPROP_CONVERT){
+        /* Fast path: no locale conversion needed. */
+        if(prop.nitems>0)
+            list=text_property_split(&prop, mode, &n);
+        ok=TRUE;
+    }else if(!ioncore_g.use_mb){
         Status st=XTextPropertyToStringList(&prop, &list, &n);
         ok=(st!=0);
     }else{
@@ -24,6 +24,34 @@ void rectangle_constrain(WRectangle *g, const WRectangle *bounds)
 }
 
 
+/* Set g to its intersection with h. Returns FALSE if that is empty. */
+bool rectangle_intersect(WRectangle *g, const WRectangle *h)
+{
+    int x1=maxof(g->x, h->x), y1=maxof(g->y, h->y);
+    int x2=minof(g->x+g->w, h->x+h->w), y2=minof(g->y+g->h, h->y+h->h);
+    
+    g->x=x1;
+    g->y=y1;
+    g->w=maxof(0, x2-x1);
+    g->h=maxof(0, y2-y1);
+    
+    return (g->w>0 && g->h>0);
+}
+
+
+/* Set g to the smallest rectangle containing both g and h. */
+void rectangle_union(WRectangle *g, const WRectangle *h)
+{
+    int x1=minof(g->x, h->x), y1=minof(g->y, h->y);
+    int x2=maxof(g->x+g->w, h->x+h->w), y2=maxof(g->y+g->h, h->y+h->h);
+    
+    g->x=x1;
+    g->y=y1;
+    g->w=x2-x1;
+    g->h=y2-y1;
+}
+
+
 bool rectangle_contains(const WRectangle *g, int x, int y)
 {
     return (x>=g->x && x<g->x+g->w && y>=g->y && y<g->y+g->h);
@@ -31,6 +31,8 @@ DECLSTRUCT(WRectangle){
 extern int rectangle_compare(const WRectangle *g, const WRectangle *h);
 extern bool rectangle_contains(const WRectangle *g, int x, int y);
 extern void rectangle_constrain(WRectangle *g, const WRectangle *bounds);
+extern bool rectangle_intersect(WRectangle *g, const WRectangle *h);
+extern void rectangle_union(WRectangle *g, const WRectangle *h);
 
 extern void rectange_debugprint(const WRectangle *g, const char *n);
 
@@ -27,6 +27,8 @@
 #define REGION_CWINS_BEING_RESCUED  0x0400
 #define REGION_PLEASE_WARP          0x0800
 #define REGION_BINDING_UPDATE_SCHEDULED 0x1000
+#define REGION_FOCUS_CHANGE_SCHEDULED   0x2000
+#define REGION_FOCUS_CHANGE_GOT         0x4000
 
 #define REGION_GOTO_FOCUS           0x0001
 #define REGION_GOTO_NOWARP          0x0002
@@ -8,11 +8,14 @@
 
 #include <stdio.h>
 #include <limits.h>
+#include <sys/time.h>
 
 #include <libtu/objp.h>
 #include <libtu/minmax.h>
+#include <libtu/debug.h>
 #include <libextl/extl.h>
 #include <libmainloop/defer.h>
+#include <libmainloop/signal.h>
 
 #include "common.h"
 #include "global.h"
@@ -28,9 +31,11 @@
 
 
 #define XOR_RESIZE (!ioncore_g.opaque_resize)
+#define OUTLINE_RESIZE(MODE) ((MODE)->outline[0]!=None)
 
 
 extern int ioncore_edge_resistance;
+extern int ioncore_moveres_rate;
 
 
 /*{{{ Size/position display and rubberband */
@@ -56,6 +61,113 @@ static void draw_rubberbox(WRootWin *rw, const WRectangle *rect)
 }
 
 
+/* The outline rubberband consists of four thin override-redirect 
+ * windows, white with a black border so as to be visible on any 
+ * background. Unlike the XOR rubberband, it needs no server grab, as
+ * other clients can't draw over it.
+ */
+
+static void outline_geom(const WRectangle *rect, int i, WRectangle *g)
+{
+    /* The X coordinates given include the border of width 1. */
+    g->x=rect->x-1;
+    g->y=rect->y-1;
+    g->w=1;
+    g->h=1;
+    
+    switch(i){
+    case 0: /* top */
+        g->w=rect->w+1;
+        break;
+    case 1: /* bottom */
+        g->y+=rect->h;
+        g->w=rect->w+1;
+        break;
+    case 2: /* left */
+        g->h=rect->h+1;
+        break;
+    case 3: /* right */
+        g->x+=rect->w;
+        g->h=rect->h+1;
+        break;
+    }
+}
+
+
+static void moveres_rubberband_geom(WMoveresMode *mode, WRectangle *rgeom)
+{
+    *rgeom=mode->geom;
+    rgeom->x+=mode->parent_rx;
+    rgeom->y+=mode->parent_ry;
+}
+
+
+static bool moveres_create_outline(WMoveresMode *mode, WRootWin *rw)
+{
+    XSetWindowAttributes attr;
+    WRectangle rgeom, g;
+    int i;
+    
+    if(rw==NULL)
+        return FALSE;
+    
+    attr.override_redirect=True;
+    attr.save_under=True;
+    attr.background_pixel=WhitePixel(ioncore_g.dpy, rw->xscr);
+    attr.border_pixel=BlackPixel(ioncore_g.dpy, rw->xscr);
+    
+    moveres_rubberband_geom(mode, &rgeom);
+    
+    for(i=0; i<4; i++){
+        outline_geom(&rgeom, i, &g);
+        mode->outline[i]=XCreateWindow(ioncore_g.dpy, WROOTWIN_ROOT(rw),
+                                       g.x, g.y, g.w, g.h, 1,
+                                       CopyFromParent, InputOutput,
+                                       CopyFromParent,
+                                       CWOverrideRedirect|CWSaveUnder|
+                                       CWBackPixel|CWBorderPixel, &attr);
+    }
+    
+    for(i=0; i<4; i++)
+        XMapRaised(ioncore_g.dpy, mode->outline[i]);
+    
+    return TRUE;
+}
+
+
+static void moveres_move_outline(WMoveresMode *mode)
+{
+    XWindowChanges wc;
+    WRectangle rgeom, g;
+    int i;
+    
+    moveres_rubberband_geom(mode, &rgeom);
+    
+    for(i=0; i<4; i++){
+        outline_geom(&rgeom, i, &g);
+        wc.x=g.x;
+        wc.y=g.y;
+        wc.width=g.w;
+        wc.height=g.h;
+        XConfigureWindow(ioncore_g.dpy, mode->outline[i],
+                         CWX|CWY|CWWidth|CWHeight, &wc);
+    }
+}
+
+
+static void moveres_destroy_outline(WMoveresMode *mode)
+{
+    int i;
+    
+    for(i=0; i<4; i++){
+        if(mode->outline[i]!=None){
+            XDestroyWindow(ioncore_g.dpy, mode->outline[i]);
+            mode->outline[i]=None;
+        }
+    }
+}
+
+
 static int max_width(GrBrush *brush, const char *str)
 {
     int maxw=0, w;
@@ -164,7 +276,7 @@ static void moveres_draw_infowin(WMoveresMode *mode)
 
 static void moveres_draw_rubberband(WMoveresMode *mode)
 {
-    WRectangle rgeom=mode->geom;
+    WRectangle rgeom;
     int rx, ry;
     WRootWin *rootwin=(mode->reg==NULL 
                        ? NULL 
@@ -173,8 +285,7 @@ static void moveres_draw_rubberband(WMoveresMode *mode)
     if(rootwin==NULL)
         return;
     
-    rgeom.x+=mode->parent_rx;
-    rgeom.y+=mode->parent_ry;
+    moveres_rubberband_geom(mode, &rgeom);
     
     if(mode->rubfn==NULL)
         draw_rubberbox(rootwin, &rgeom);
@@ -192,6 +303,18 @@ static void moveres_draw_rubberband(WMoveresMode *mode)
 WMoveresMode *tmpmode=NULL;
 
 
+/* Opaque pointer moves and resizes are applied at most 
+ * ioncore_moveres_rate times per second. A request arriving sooner is
+ * kept pending, replacing any earlier pending one, until the timer 
+ * expires or the operation ends.
+ */
+static WTimer *update_timer=NULL;
+static WRQGeomParams pending_rq;
+static bool pending=FALSE;
+static struct timeval start_tv, last_update_tv;
+static int n_requests=0, n_updates=0;
+
+
 EXTL_EXPORT
 IMPLCLASS(WMoveresMode, Obj, NULL, NULL);
 
@@ -242,6 +365,17 @@ static bool moveresmode_init(WMoveresMode *mode, WRegion *reg,
     mode->rqflags=(XOR_RESIZE ? REGION_RQGEOM_TRYONLY : 0);
     mode->reg=reg;
     mode->mode=MOVERES_SIZE;
+    mode->outline[0]=None;
+    mode->outline[1]=None;
+    mode->outline[2]=None;
+    mode->outline[3]=None;
+    
+    pending=FALSE;
+    n_requests=0;
+    n_updates=0;
+    gettimeofday(&start_tv, NULL);
+    last_update_tv.tv_sec=0;
+    last_update_tv.tv_usec=0;
     
     /* Get snapping geometry */
     mgr=REGION_MANAGER(reg);
@@ -272,8 +406,12 @@ static bool moveresmode_init(WMoveresMode *mode, WRegion *reg,
     moveres_draw_infowin(mode);
     
     if(XOR_RESIZE){
-        XGrabServer(ioncore_g.dpy);
-        moveres_draw_rubberband(mode);
+        /* Custom rubberbands are drawn on the root window. */
+        if(rubfn!=NULL || ioncore_g.xor_rubberband ||
+           !moveres_create_outline(mode, region_rootwin_of(reg))){
+            XGrabServer(ioncore_g.dpy);
+            moveres_draw_rubberband(mode);
+        }
     }
     
     return TRUE;
@@ -328,7 +466,9 @@ static void moveresmode_setorig(WMoveresMode *mode)
 
 static void moveresmode_do_newgeom(WMoveresMode *mode, WRQGeomParams *rq)
 {    
-    if(XOR_RESIZE)
+    bool xor=(XOR_RESIZE && !OUTLINE_RESIZE(mode));
+    
+    if(xor)
         moveres_draw_rubberband(mode);
     
     if(mode->reg!=NULL){
@@ -338,8 +478,92 @@ static void moveresmode_do_newgeom(WMoveresMode *mode, WRQGeomParams *rq)
     
     moveres_draw_infowin(mode);
     
-    if(XOR_RESIZE)
+    if(xor)
         moveres_draw_rubberband(mode);
+    else if(OUTLINE_RESIZE(mode))
+        moveres_move_outline(mode);
+}
+
+
+static long tvdiffmsec(struct timeval *tv1, struct timeval *tv2)
+{
+    double t1=1000*(double)tv1->tv_sec+(double)tv1->tv_usec/1000;
+    double t2=1000*(double)tv2->tv_sec+(double)tv2->tv_usec/1000;
+    
+    return (long)(t1-t2);
+}
+
+
+static void moveresmode_apply(WMoveresMode *mode, WRQGeomParams *rq)
+{
+    gettimeofday(&last_update_tv, NULL);
+    n_updates++;
+    moveresmode_do_newgeom(mode, rq);
+}
+
+
+static void moveresmode_apply_pending(WMoveresMode *mode)
+{
+    if(update_timer!=NULL)
+        timer_reset(update_timer);
+    
+    if(pending){
+        pending=FALSE;
+        moveresmode_apply(mode, &pending_rq);
+    }
+}
+
+
+static void tmr_apply_pending(WTimer *unused, WMoveresMode *mode)
+{
+    if(mode!=NULL && mode==tmpmode)
+        moveresmode_apply_pending(mode);
+}
+
+
+static void moveresmode_newgeom(WMoveresMode *mode, WRQGeomParams *rq)
+{
+    struct timeval tv;
+    long interval, elapsed;
+    
+    n_requests++;
+    
+    /* Keyboard resizes and rubberbands are cheap enough, and the former
+     * need the result immediately.
+     */
+    if(XOR_RESIZE || !mode->resize_cumulative || ioncore_moveres_rate<=0){
+        moveresmode_apply(mode, rq);
+        return;
+    }
+    
+    interval=1000/ioncore_moveres_rate;
+    
+    gettimeofday(&tv, NULL);
+    elapsed=tvdiffmsec(&tv, &last_update_tv);
+    
+    if(elapsed<0 || elapsed>=interval){
+        pending=FALSE;
+        if(update_timer!=NULL)
+            timer_reset(update_timer);
+        moveresmode_apply(mode, rq);
+        return;
+    }
+    
+    pending_rq=*rq;
+    pending=TRUE;
+    
+    if(update_timer==NULL){
+        update_timer=create_timer();
+        if(update_timer==NULL){
+            moveresmode_apply_pending(mode);
+            return;
+        }
+    }
+    
+    if(!timer_is_set(update_timer)){
+        timer_set(update_timer, interval-elapsed,
+                  (WTimerHandler*)tmr_apply_pending, (Obj*)mode);
+    }
 }
 
 
@@ -420,7 +644,7 @@ static void moveresmode_delta(WMoveresMode *mode,
             rq.geom.y+=mode->origgeom.h-rq.geom.h;
     }
     
-    moveresmode_do_newgeom(mode, &rq);
+    moveresmode_newgeom(mode, &rq);
     
     if(!mode->resize_cumulative)
         moveresmode_setorig(mode);
@@ -486,10 +710,29 @@ bool moveresmode_do_end(WMoveresMode *mode, bool apply)
     assert(reg!=NULL);
     assert(tmpmode==mode);
     
+    /* The final geometry must always be applied. */
+    moveresmode_apply_pending(mode);
+    
+    D({
+        struct timeval tv;
+        long msec;
+        gettimeofday(&tv, NULL);
+        msec=maxof(1, tvdiffmsec(&tv, &start_tv));
+        warn("Move/resize: %d requests, %d updates in %ld ms "
+             "(%.1f updates/s).", n_requests, n_updates, msec,
+             n_updates*1000.0/msec);
+    });
+    
     tmpmode=NULL;
     
     if(XOR_RESIZE){
-        moveres_draw_rubberband(mode);
+        bool outline=OUTLINE_RESIZE(mode);
+        
+        if(outline)
+            moveres_destroy_outline(mode);
+        else
+            moveres_draw_rubberband(mode);
+        
         if(apply){
             WRQGeomParams rq=RQGEOMPARAMS_INIT;
             
@@ -498,7 +741,9 @@ bool moveresmode_do_end(WMoveresMode *mode, bool apply)
 
             region_rqgeom(reg, &rq, &mode->geom);
         }
-        XUngrabServer(ioncore_g.dpy);
+        
+        if(!outline)
+            XUngrabServer(ioncore_g.dpy);
     }
     if(apply)
         set_saved(mode, reg);
@@ -71,6 +71,7 @@ DECLCLASS(WMoveresMode){
     WRectangle snapgeom;
     int rqflags;
     WInfoWin *infowin;
+    Window outline[4];
 };
 
 
@@ -227,6 +227,11 @@ static bool rootwin_init(WRootWin *rootwin, int xscr)
     rootwin->tmpnwins=0;
     rootwin->dummy_win=None;
     rootwin->xor_gc=None;
+    rootwin->net_client_list=NULL;
+    rootwin->net_client_list_stacking=NULL;
+    rootwin->net_client_list_n=0;
+    rootwin->net_client_list_alloc=0;
+    rootwin->net_client_list_scheduled=FALSE;
 
     fp.mode=REGION_FIT_EXACT;
     fp.g.x=0; fp.g.y=0;
@@ -282,6 +287,8 @@ void rootwin_deinit(WRootWin *rw)
     
     XFreeGC(ioncore_g.dpy, rw->xor_gc);
     
+    netwm_deinit_rootwin(rw);
+    
     rw->scr.mplex.win.win=None;
 
     screen_deinit(&rw->scr);
@@ -36,6 +36,15 @@ DECLCLASS(WRootWin){
     Window dummy_win;
     
     GC xor_gc;
+    
+    /* _NET_CLIENT_LIST (order of management) and 
+     * _NET_CLIENT_LIST_STACKING (bottom to top) 
+     */
+    WClientWin **net_client_list;
+    WClientWin **net_client_list_stacking;
+    int net_client_list_n;
+    int net_client_list_alloc;
+    bool net_client_list_scheduled;
 };
 
 
@@ -184,6 +184,155 @@ int str_len(const char *p)
 /*}}}*/
 
 
+/*{{{ Label cache */
+
+
+/* Labels are remembered by (string, maximum width, brush). All brushes
+ * of a style share its font, and brushes are released and re-fetched
+ * when styles are reloaded, so the brush stands in for the font.
+ */
+
+#define LABEL_CACHE_SIZE 256
+#define LABEL_CACHE_BUCKETS 128
+
+
+INTRSTRUCT(LabelCacheEntry);
+
+DECLSTRUCT(LabelCacheEntry){
+    uint hash;
+    uint maxw;
+    GrBrush *brush;
+    char *str;
+    char *label;
+    uint w;
+    LabelCacheEntry *hnext;
+    LabelCacheEntry *next, *prev;
+};
+
+
+static LabelCacheEntry *label_buckets[LABEL_CACHE_BUCKETS];
+static LabelCacheEntry *label_lru=NULL;
+static int label_count=0;
+
+
+static uint label_hash(GrBrush *brush, const char *str, uint maxw)
+{
+    uint h=2166136261u^maxw^(uint)(((unsigned long)brush)>>4);
+    
+    while(*str!='\0'){
+        h^=(unsigned char)*str++;
+        h*=16777619u;
+    }
+    
+    return h;
+}
+
+
+static void label_cache_remove(LabelCacheEntry *ent)
+{
+    LabelCacheEntry **p=&label_buckets[ent->hash&(LABEL_CACHE_BUCKETS-1)];
+    
+    while(*p!=ent)
+        p=&(*p)->hnext;
+    *p=ent->hnext;
+    
+    UNLINK_ITEM(label_lru, ent, next, prev);
+    label_count--;
+    
+    free(ent->str);
+    free(ent->label);
+    free(ent);
+}
+
+
+static char *label_cache_lookup(GrBrush *brush, const char *str, uint maxw,
+                                uint *w_ret)
+{
+    uint h=label_hash(brush, str, maxw);
+    LabelCacheEntry *ent;
+    
+    for(ent=label_buckets[h&(LABEL_CACHE_BUCKETS-1)]; 
+        ent!=NULL; ent=ent->hnext){
+        if(ent->hash==h && ent->brush==brush && ent->maxw==maxw
+           && strcmp(ent->str, str)==0){
+            if(ent!=label_lru){
+                UNLINK_ITEM(label_lru, ent, next, prev);
+                LINK_ITEM_FIRST(label_lru, ent, next, prev);
+            }
+            if(w_ret!=NULL)
+                *w_ret=ent->w;
+            return scopy(ent->label);
+        }
+    }
+    
+    return NULL;
+}
+
+
+static void label_cache_store(GrBrush *brush, const char *str, uint maxw,
+                              const char *label, uint w)
+{
+    LabelCacheEntry *ent;
+    uint b;
+    
+    if(label_count>=LABEL_CACHE_SIZE)
+        label_cache_remove(label_lru->prev);
+    
+    ent=ALLOC(LabelCacheEntry);
+    
+    if(ent==NULL)
+        return;
+    
+    ent->str=scopy(str);
+    ent->label=scopy(label);
+    
+    if(ent->str==NULL || ent->label==NULL){
+        if(ent->str!=NULL)
+            free(ent->str);
+        if(ent->label!=NULL)
+            free(ent->label);
+        free(ent);
+        return;
+    }
+    
+    ent->brush=brush;
+    ent->maxw=maxw;
+    ent->w=w;
+    ent->hash=label_hash(brush, str, maxw);
+    
+    b=ent->hash&(LABEL_CACHE_BUCKETS-1);
+    ent->hnext=label_buckets[b];
+    label_buckets[b]=ent;
+    
+    LINK_ITEM_FIRST(label_lru, ent, next, prev);
+    label_count++;
+}
+
+
+/* Forget labels made with brush, which is going away. */
+void grbrush_flush_labels(GrBrush *brush)
+{
+    LabelCacheEntry *ent, *next;
+    
+    for(ent=label_lru; ent!=NULL; ent=next){
+        next=ent->next;
+        if(ent->brush==brush)
+            label_cache_remove(ent);
+    }
+}
+
+
+/* Forget all labels. Called when shortening rules or styles change. */
+void ioncore_flush_labels()
+{
+    while(label_lru!=NULL)
+        label_cache_remove(label_lru);
+}
+
+
+/*}}}*/
+
+
 /*{{{ Title shortening */
 
 
@@ -273,6 +422,8 @@ bool ioncore_defshortening(const char *rx, const char *rule, bool always)
     
     LINK_ITEM(shortenrules, si, next, prev);
     
+    ioncore_flush_labels();
+    
     return TRUE;
     
 fail:
@@ -283,8 +434,119 @@ fail2:
 }
 
 
+/* Returns the character boundaries in s[from..to] (from and to included).
+ */
+static int *char_offsets(const char *s, int from, int to, int *n_ret)
+{
+    int *off=ALLOC_N(int, to-from+1);
+    int n=0, pos=from, l;
+    
+    if(off==NULL)
+        return NULL;
+    
+    off[n++]=from;
+    
+    while(pos<to){
+        l=str_nextoff(s, pos);
+        if(l==0)
+            break;
+        pos+=l;
+        off[n++]=(pos<to ? pos : to);
+    }
+    
+    if(off[n-1]!=to)
+        off[n++]=to;
+    
+    *n_ret=n;
+    return off;
+}
+
+
+/* Find the cut points i<=strippt<=j such that s[0..i]s[j..slen] fits 
+ * in maxw, removing as few characters as possible on the side of strippt
+ * given by stripdir. The width of the prefix or suffix being stripped is
+ * monotone in the number of characters kept, so the cut point is found 
+ * by binary search over the character boundaries, measuring only 
+ * O(log n) substrings instead of every one of them.
+ */
+static bool fit_label(GrBrush *brush, const char *s, int slen,
+                      int strippt, int stripdir, uint maxw,
+                      int *i_ret, int *j_ret)
+{
+    uint fixed, w;
+    int *off, n, lo, hi, mid, best;
+    
+    if(stripdir==-1){
+        fixed=grbrush_get_text_width(brush, s+strippt, slen-strippt);
+        w=grbrush_get_text_width(brush, s, strippt);
+    }else{
+        fixed=grbrush_get_text_width(brush, s, strippt);
+        w=grbrush_get_text_width(brush, s+strippt, slen-strippt);
+    }
+    
+    /* fixed+w may not be the actual length, but close enough. */
+    if(fixed+w<=maxw){
+        *i_ret=strippt;
+        *j_ret=strippt;
+        return TRUE;
+    }
+    
+    if(fixed>maxw)
+        return FALSE;
+    
+    if(stripdir==-1)
+        off=char_offsets(s, 0, strippt, &n);
+    else
+        off=char_offsets(s, strippt, slen, &n);
+    
+    if(off==NULL)
+        return FALSE;
+    
+    /* Stripping everything always fits; find the boundary keeping the
+     * most characters. */
+    if(stripdir==-1){
+        best=0;
+        lo=1;
+        hi=n-2;
+        while(lo<=hi){
+            mid=(lo+hi)/2;
+            w=grbrush_get_text_width(brush, s, off[mid]);
+            if(fixed+w<=maxw){
+                best=mid;
+                lo=mid+1;
+            }else{
+                hi=mid-1;
+            }
+        }
+        *i_ret=off[best];
+        *j_ret=strippt;
+    }else{
+        best=n-1;
+        lo=1;
+        hi=n-2;
+        while(lo<=hi){
+            mid=(lo+hi)/2;
+            w=grbrush_get_text_width(brush, s+off[mid], slen-off[mid]);
+            if(fixed+w<=maxw){
+                best=mid;
+                hi=mid-1;
+            }else{
+                lo=mid+1;
+            }
+        }
+        *i_ret=strippt;
+        *j_ret=off[best];
+    }
+    
+    free(off);
+    
+    return TRUE;
+}
+
+
 static char *shorten(GrBrush *brush, const char *str, uint maxw,
-                     const char *rule, int nmatch, regmatch_t *pmatch)
+                     const char *rule, int nmatch, regmatch_t *pmatch,
+                     uint *w_ret)
 {
     char *s;
     int rulelen, slen, i, j, k, ll;
@@ -304,6 +566,7 @@ static char *shorten(GrBrush *brush, const char *str, uint maxw,
             len=mbrtowc(NULL, str+pos, strl-pos, &ps);
             if(len<0){
                 /* Invalid multibyte string */
+                *w_ret=grbrush_get_text_width(brush, "???", 3);
                 return scopy("???");
             }
             if(len==0)
@@ -386,35 +649,11 @@ static char *shorten(GrBrush *brush, const char *str, uint maxw,
         slen=j;
         s[slen]='\0';
         
-        i=strippt;
-        j=strippt;
-        
-        /* shorten */
-        {
-            uint bl=grbrush_get_text_width(brush, s, i);
-            uint el=grbrush_get_text_width(brush, s+j, slen-j);
-
-            while(1){
-                /* el+bl may not be the actual length, but close enough. */
-                if(el+bl<=maxw){
-                    memmove(s+i, s+j, slen-j+1);
-                    return s;
-                }
-                
-                if(stripdir==-1){
-                    ll=str_prevoff(s, i);
-                    if(ll==0)
-                        break;
-                    i-=ll;
-                    bl=grbrush_get_text_width(brush, s, i);
-                }else{
-                    ll=str_nextoff(s, j);
-                    if(ll==0)
-                        break;
-                    j+=ll;
-                    el=grbrush_get_text_width(brush, s+j, slen-j);
-                }
-            }
+        if(fit_label(brush, s, slen, strippt, stripdir, maxw, &i, &j)){
+            memmove(s+i, s+j, slen-j+1);
+            /* Callers lay out by this width, so measure the result. */
+            *w_ret=grbrush_get_text_width(brush, s, slen-(j-i));
+            return s;
         }
     }while(more);
         
@@ -424,7 +663,8 @@ static char *shorten(GrBrush *brush, const char *str, uint maxw,
 }
 
 
-char *grbrush_make_label(GrBrush *brush, const char *str, uint maxw)
+static char *do_make_label(GrBrush *brush, const char *str, uint maxw,
+                           uint *w_ret)
 {
     size_t nmatch=10;
     regmatch_t pmatch[10];
@@ -432,8 +672,9 @@ char *grbrush_make_label(GrBrush *brush, const char *str, uint maxw)
     int ret;
     char *retstr;
     bool fits=FALSE;
+    uint w=grbrush_get_text_width(brush, str, strlen(str));
     
-    if(grbrush_get_text_width(brush, str, strlen(str))<=maxw)
+    if(w<=maxw)
         fits=TRUE;
         
         /*return scopy(str);*/
@@ -444,7 +685,7 @@ char *grbrush_make_label(GrBrush *brush, const char *str, uint maxw)
         ret=regexec(&(rule->re), str, nmatch, pmatch, 0);
         if(ret!=0)
             continue;
-        retstr=shorten(brush, str, maxw, rule->rule, nmatch, pmatch);
+        retstr=shorten(brush, str, maxw, rule->rule, nmatch, pmatch, &w);
         goto rettest;
     }
 
@@ -453,13 +694,45 @@ char *grbrush_make_label(GrBrush *brush, const char *str, uint maxw)
     }else{
         pmatch[0].rm_so=0;
         pmatch[0].rm_eo=strlen(str)-1;
-        retstr=shorten(brush, str, maxw, "$1$<...", 1, pmatch);
+        retstr=shorten(brush, str, maxw, "$1$<...", 1, pmatch, &w);
     }
     
 rettest:
-    if(retstr!=NULL)
-        return retstr;
-    return scopy("");
+    if(retstr==NULL){
+        retstr=scopy("");
+        w=0;
+    }
+    
+    *w_ret=w;
+    
+    return retstr;
+}
+
+
+char *grbrush_make_label(GrBrush *brush, const char *str, uint maxw)
+{
+    return grbrush_make_label2(brush, str, maxw, NULL);
+}
+
+
+char *grbrush_make_label2(GrBrush *brush, const char *str, uint maxw,
+                          uint *w_ret)
+{
+    char *label=label_cache_lookup(brush, str, maxw, w_ret);
+    uint w;
+    
+    if(label!=NULL)
+        return label;
+    
+    label=do_make_label(brush, str, maxw, &w);
+    
+    if(label!=NULL)
+        label_cache_store(brush, str, maxw, label, w);
+    
+    if(w_ret!=NULL)
+        *w_ret=w;
+    
+    return label;
 }
 
 
@@ -24,6 +24,10 @@ extern bool ioncore_defshortening(const char *rx, const char *rule,
                                   bool always);
 
 extern char *grbrush_make_label(GrBrush *brush, const char *str, uint maxw);
+extern char *grbrush_make_label2(GrBrush *brush, const char *str, uint maxw,
+                                 uint *w_ret);
+extern void grbrush_flush_labels(GrBrush *brush);
+extern void ioncore_flush_labels();
                                        
 extern int str_nextoff(const char *p, int pos);
 extern int str_prevoff(const char *p, int pos);
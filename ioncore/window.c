@@ -8,6 +8,7 @@
 
 #include <libtu/objp.h>
 #include <libtu/minmax.h>
+#include <libmainloop/defer.h>
 
 #include "common.h"
 #include "global.h"
@@ -16,6 +17,7 @@
 #include "rootwin.h"
 #include "region.h"
 #include "xwindow.h"
+#include "backing.h"
 #include "region-iter.h"
 
 
@@ -28,6 +30,19 @@ void window_draw(WWindow *wwin, bool complete)
 }
 
 
+/* Redraw the part of the window within clip, in window coordinates.
+ * Windows that do not implement this are redrawn as a whole.
+ */
+void window_draw_clipped(WWindow *wwin, const WRectangle *clip)
+{
+    if(HAS_DYN(wwin, window_draw_clipped)){
+        CALL_DYN(window_draw_clipped, wwin, (wwin, clip));
+    }else{
+        window_draw(wwin, FALSE);
+    }
+}
+
+
 void window_insstr(WWindow *wwin, const char *buf, size_t n)
 {
     CALL_DYN(window_insstr, wwin, (wwin, buf, n));
@@ -51,12 +66,131 @@ void window_release(WWindow *wwin)
 /*}}}*/
     
 
+/*{{{ Scheduled drawing */
+
+
+/* Windows with draws pending. They are drawn by ioncore_draw_pending
+ * once all queued events have been handled, so that a window that is 
+ * e.g. activated, renamed and exposed while handling a batch of events
+ * is drawn only once.
+ */
+static WDeferred *draw_list=NULL;
+static int draws_saved=0;
+
+
+static void window_draw_damage(WWindow *wwin)
+{
+    WRectangle g;
+    
+    g.x=0;
+    g.y=0;
+    g.w=REGION_GEOM(wwin).w;
+    g.h=REGION_GEOM(wwin).h;
+    
+    if(!rectangle_intersect(&g, &wwin->damage))
+        return;
+    
+    if(g.w==REGION_GEOM(wwin).w && g.h==REGION_GEOM(wwin).h)
+        window_draw(wwin, FALSE);
+    else
+        window_draw_clipped(wwin, &g);
+}
+
+
+static void window_do_draw_pending(WWindow *wwin)
+{
+    int flags=wwin->draw_flags;
+    
+    wwin->draw_flags=0;
+    
+    if(flags&WWINDOW_DRAW_COMPLETE)
+        window_draw(wwin, TRUE);
+    else if(flags&WWINDOW_DRAW_PARTIAL)
+        window_draw(wwin, FALSE);
+    else if(flags&WWINDOW_DRAW_DAMAGE)
+        window_draw_damage(wwin);
+}
+
+
+static void window_schedule_draw(WWindow *wwin, int flag)
+{
+    if(wwin->draw_flags==0){
+        mainloop_defer_action_on_list((Obj*)wwin, 
+                                      (WDeferredAction*)window_do_draw_pending,
+                                      &draw_list);
+    }else{
+        /* Merged into the pending draw. */
+        draws_saved++;
+    }
+    
+    wwin->draw_flags|=flag;
+}
+
+
+/* Add geom, in window coordinates, to the area that needs to be redrawn
+ * once the pending events have been handled.
+ */
+void window_add_damage(WWindow *wwin, const WRectangle *geom)
+{
+    if(wwin->draw_flags&WWINDOW_DRAW_DAMAGE)
+        rectangle_union(&wwin->damage, geom);
+    else
+        wwin->damage=*geom;
+    
+    window_schedule_draw(wwin, WWINDOW_DRAW_DAMAGE);
+}
+
+
+/* Draw wwin, like window_draw, but only once the pending events
+ * have been handled. 
+ */
+void window_draw_later(WWindow *wwin, bool complete)
+{
+    window_schedule_draw(wwin, (complete 
+                                ? WWINDOW_DRAW_COMPLETE 
+                                : WWINDOW_DRAW_PARTIAL));
+}
+
+
+/* Is a full redraw of wwin pending? Partial updates can then be 
+ * skipped.
+ */
+bool window_draw_is_pending(WWindow *wwin)
+{
+    return ((wwin->draw_flags&(WWINDOW_DRAW_PARTIAL|WWINDOW_DRAW_COMPLETE))
+            !=0);
+}
+
+
+void ioncore_draw_pending()
+{
+    mainloop_execute_deferred_on_list(&draw_list);
+}
+
+
+/*EXTL_DOC
+ * Returns the number of window redraws that have been avoided by 
+ * combining them with another pending redraw of the same window.
+ */
+EXTL_SAFE
+EXTL_EXPORT
+int ioncore_draws_saved()
+{
+    return draws_saved;
+}
+
+
+/*}}}*/
+
+
 /*{{{ Init, create */
 
 
 bool window_do_init(WWindow *wwin, WWindow *par, 
                     const WFitParams *fp, Window win)
 {
+    bool created=(win==None);
+    
     if(win==None){
         assert(par!=NULL);
         win=create_xwindow(region_rootwin_of((WRegion*)par),
@@ -69,9 +203,13 @@ bool window_do_init(WWindow *wwin, WWindow *par,
     wwin->xic=NULL;
     wwin->event_mask=0;
     wwin->stacking=NULL;
+    wwin->draw_flags=0;
     
     region_init(&(wwin->region), par, fp);
     
+    if(created)
+        window_apply_backing(wwin);
+    
     XSaveContext(ioncore_g.dpy, win, ioncore_g.win_context, 
                  (XPointer)wwin);
     
@@ -15,12 +15,19 @@
 #include "rectangle.h"
 
 
+#define WWINDOW_DRAW_DAMAGE 0x0001
+#define WWINDOW_DRAW_PARTIAL 0x0002
+#define WWINDOW_DRAW_COMPLETE 0x0004
+
+
 DECLCLASS(WWindow){
     WRegion region;
     Window win;
     XIC xic;
     long event_mask;
     WStacking *stacking;
+    int draw_flags;
+    WRectangle damage;
 };
 
 
@@ -31,6 +38,7 @@ extern bool window_do_init(WWindow *p, WWindow *parent,
 extern void window_deinit(WWindow *win);
 
 DYNFUN void window_draw(WWindow *wwin, bool complete);
+DYNFUN void window_draw_clipped(WWindow *wwin, const WRectangle *clip);
 DYNFUN void window_insstr(WWindow *wwin, const char *buf, size_t n);
 DYNFUN int window_press(WWindow *wwin, XButtonEvent *ev, WRegion **reg_ret);
 DYNFUN void window_release(WWindow *wwin);
@@ -51,4 +59,9 @@ extern void window_restack(WWindow *wwin, Window other, int mode);
 
 extern void window_select_input(WWindow *wwin, long event_mask);
 
+extern void window_add_damage(WWindow *wwin, const WRectangle *geom);
+extern void window_draw_later(WWindow *wwin, bool complete);
+extern bool window_draw_is_pending(WWindow *wwin);
+extern void ioncore_draw_pending();
+
 #endif /* ION_IONCORE_WINDOW_H */
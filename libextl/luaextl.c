@@ -1033,30 +1033,82 @@ typedef struct{
 } TableParams2;
 
 
-static bool extl_table_dodo_get2(lua_State *st, TableParams2 *params)
+typedef struct{
+    ExtlTab ref;
+    char type;
+    ExtlAny key;
+    void *valret;
+} TableGetParams;
+
+
+static bool extl_table_dodo_get2(lua_State *st, TableGetParams *params)
 {
     if(params->ref<0)
         return FALSE;
 
     lua_rawgeti(st, LUA_REGISTRYINDEX, params->ref);
-    extl_stack_push_vararg(st, params->itype, params->argsp);
+    extl_stack_pusha(st, &(params->key));
     lua_gettable(st, -2);
     if(lua_isnil(st, -1))
         return FALSE;
     
-    return extl_stack_get(st, -1, params->type, TRUE, NULL,
-                          va_arg(*(params->argsp), void*));
+    return extl_stack_get(st, -1, params->type, TRUE, NULL, params->valret);
+}
+
+
+/* Reading a string- or integer-keyed field needs no protected call, 
+ * as long as no metamethod can get involved and the value needs no
+ * checking. Returns -1 if the protected path must be used instead.
+ */
+static int extl_table_get_fast(TableGetParams *params)
+{
+    lua_State *st=l_st;
+    int oldtop, ret=-1;
+    
+    if(params->ref<0 || (params->key.type!='s' && params->key.type!='i'))
+        return -1;
+    
+    if(!lua_checkstack(st, 3))
+        return -1;
+    
+    oldtop=lua_gettop(st);
+    
+    lua_rawgeti(st, LUA_REGISTRYINDEX, params->ref);
+    if(!lua_istable(st, -1))
+        goto out;
+    
+    extl_stack_pusha(st, &(params->key));
+    lua_rawget(st, -2);
+    
+    if(lua_isnil(st, -1)){
+        /* An __index metamethod might still provide a value. */
+        if(lua_getmetatable(st, -2))
+            goto out;
+        ret=FALSE;
+    }else if(lua_type(st, -1)!=LUA_TUSERDATA){
+        ret=extl_stack_get(st, -1, params->type, TRUE, NULL, 
+                           params->valret);
+    }
+    
+out:
+    lua_settop(st, oldtop);
+    return ret;
 }
 
 
 bool extl_table_get_vararg(ExtlTab ref, char itype, char type, va_list *args)
 {
-    TableParams2 params;
+    TableGetParams params;
+    int ret;
     
     params.ref=ref;
-    params.itype=itype;
     params.type=type;
-    params.argsp=args;
+    extl_to_any_vararg(&(params.key), itype, args);
+    params.valret=va_arg(*args, void*);
+    
+    ret=extl_table_get_fast(&params);
+    if(ret>=0)
+        return ret;
     
     return extl_cpcall(l_st, (ExtlCPCallFn*)extl_table_dodo_get2, &params);
 }
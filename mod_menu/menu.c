@@ -107,10 +107,10 @@ static void init_attr()
 }
 
 
-static void menu_draw_entry(WMenu *menu, int i, const WRectangle *igeom,
-                            bool complete)
+static void menu_do_draw_entry(WMenu *menu, int i, const WRectangle *igeom,
+                               bool complete, const WRectangle *clip)
 {
-    WRectangle geom;
+    WRectangle geom, cg;
     GrAttr sa, aa;
 
     aa=(REGION_IS_ACTIVE(menu) ? GR_ATTR(active) : GR_ATTR(inactive));
@@ -123,7 +123,16 @@ static void menu_draw_entry(WMenu *menu, int i, const WRectangle *igeom,
     geom.h=menu->entry_h;
     geom.y+=(i-menu->first_entry)*(menu->entry_h+menu->entry_spacing);
     
-    grbrush_begin(menu->entry_brush, &geom, GRBRUSH_AMEND|GRBRUSH_KEEP_ATTR);
+    if(clip==NULL){
+        grbrush_begin(menu->entry_brush, &geom, 
+                      GRBRUSH_AMEND|GRBRUSH_KEEP_ATTR);
+    }else{
+        cg=geom;
+        if(!rectangle_intersect(&cg, clip))
+            return;
+        grbrush_begin(menu->entry_brush, &cg, 
+                      GRBRUSH_AMEND|GRBRUSH_KEEP_ATTR|GRBRUSH_NEED_CLIP);
+    }
     
     grbrush_init_attr(menu->entry_brush, &menu->entries[i].attr);
     
@@ -136,8 +145,16 @@ static void menu_draw_entry(WMenu *menu, int i, const WRectangle *igeom,
     grbrush_end(menu->entry_brush);
 }
 
+
+static void menu_draw_entry(WMenu *menu, int i, const WRectangle *igeom,
+                            bool complete)
+{
+    menu_do_draw_entry(menu, i, igeom, complete, NULL);
+}
+
     
-void menu_draw_entries(WMenu *menu, bool complete)
+static void menu_do_draw_entries(WMenu *menu, bool complete, 
+                                 const WRectangle *clip)
 {
     WRectangle igeom;
     int i, mx;
@@ -151,33 +168,57 @@ void menu_draw_entries(WMenu *menu, bool complete)
     mx=(mx < menu->n_entries ? mx : menu->n_entries);
     
     for(i=menu->first_entry; i<mx; i++)
-        menu_draw_entry(menu, i, &igeom, complete);
+        menu_do_draw_entry(menu, i, &igeom, complete, clip);
 }
 
 
-void menu_draw(WMenu *menu, bool complete)
+void menu_draw_entries(WMenu *menu, bool complete)
+{
+    menu_do_draw_entries(menu, complete, NULL);
+}
+
+
+static void menu_do_draw(WMenu *menu, bool complete, const WRectangle *clip)
 {
     GrAttr aa=(REGION_IS_ACTIVE(menu) ? GR_ATTR(active) : GR_ATTR(inactive));
-    WRectangle geom;
+    WRectangle geom, cg;
     
     if(menu->brush==NULL)
         return;
     
     get_outer_geom(menu, &geom);
     
-    grbrush_begin(menu->brush, &geom, 
-                  (complete ? 0 : GRBRUSH_NO_CLEAR_OK));
+    cg=geom;
+    
+    if(clip!=NULL && !rectangle_intersect(&cg, clip))
+        return;
+    
+    grbrush_begin(menu->brush, &cg, 
+                  (complete ? 0 : GRBRUSH_NO_CLEAR_OK)
+                  |(clip!=NULL ? GRBRUSH_NEED_CLIP : 0));
     
     grbrush_set_attr(menu->brush, aa);
     
     grbrush_draw_border(menu->brush, &geom);
     
-    menu_draw_entries(menu, FALSE);
+    menu_do_draw_entries(menu, FALSE, clip);
     
     grbrush_end(menu->brush);
 }
 
 
+void menu_draw(WMenu *menu, bool complete)
+{
+    menu_do_draw(menu, complete, NULL);
+}
+
+
+void menu_draw_clipped(WMenu *menu, const WRectangle *clip)
+{
+    menu_do_draw(menu, FALSE, clip);
+}
+
+
 /*}}}*/
 
 
@@ -503,7 +544,7 @@ void menu_updategr(WMenu *menu)
     
     region_updategr_default((WRegion*)menu);
     
-    window_draw((WWindow*)menu, TRUE);
+    window_draw_later((WWindow*)menu, TRUE);
 }
 
 
@@ -710,13 +751,13 @@ void menu_deinit(WMenu *menu)
 
 static void menu_inactivated(WMenu *menu)
 {
-    window_draw((WWindow*)menu, FALSE);
+    window_draw_later((WWindow*)menu, FALSE);
 }
 
 
 static void menu_activated(WMenu *menu)
 {
-    window_draw((WWindow*)menu, FALSE);
+    window_draw_later((WWindow*)menu, FALSE);
 }
 
 
@@ -1430,6 +1471,7 @@ static DynFunTab menu_dynfuntab[]={
     {(DynFun*)region_fitrep, (DynFun*)menu_fitrep},
     {region_updategr, menu_updategr},
     {window_draw, menu_draw},
+    {window_draw_clipped, menu_draw_clipped},
     {(DynFun*)window_press, (DynFun*)menu_press},
     {region_managed_remove, menu_managed_remove},
     {region_do_set_focus, menu_do_set_focus},
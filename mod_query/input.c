@@ -105,7 +105,7 @@ void input_updategr(WInput *input)
     
     region_updategr_default((WRegion*)input);
     
-    window_draw((WWindow*)input, TRUE);
+    window_draw_later((WWindow*)input, TRUE);
 }
 
 
@@ -174,13 +174,13 @@ void input_cancel(WInput *input)
 
 static void input_inactivated(WInput *input)
 {
-    window_draw((WWindow*)input, FALSE);
+    window_draw_later((WWindow*)input, FALSE);
 }
 
 
 static void input_activated(WInput *input)
 {
-    window_draw((WWindow*)input, FALSE);
+    window_draw_later((WWindow*)input, FALSE);
 }
 
 
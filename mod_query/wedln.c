@@ -462,6 +462,43 @@ void wedln_draw(WEdln *wedln, bool complete)
     wedln_draw_(wedln, complete, TRUE);
 }
 
+
+/* The text box already sets a clipping rectangle of its own, so rather
+ * than clip at pixel level, redraw only the parts that were damaged.
+ */
+void wedln_draw_clipped(WEdln *wedln, const WRectangle *clip)
+{
+    WRectangle g;
+    bool completions=FALSE, textarea;
+    
+    if(WEDLN_BRUSH(wedln)==NULL)
+        return;
+    
+    if(wedln->compl_list.strs!=NULL){
+        get_completions_geom(wedln, G_CURRENT, &g);
+        completions=rectangle_intersect(&g, clip);
+    }
+    
+    get_outer_geom(wedln, G_CURRENT, &g);
+    textarea=rectangle_intersect(&g, clip);
+    
+    if(!textarea){
+        if(!completions)
+            return;
+        
+        get_geom(wedln, G_CURRENT, &g);
+        
+        grbrush_begin(WEDLN_BRUSH(wedln), &g, GRBRUSH_NO_CLEAR_OK);
+        grbrush_set_attr(WEDLN_BRUSH(wedln), REGION_IS_ACTIVE(wedln) 
+                                             ? GR_ATTR(active) 
+                                             : GR_ATTR(inactive));
+        wedln_draw_completions(wedln, LISTING_DRAW_ALL);
+        grbrush_end(WEDLN_BRUSH(wedln));
+    }else{
+        wedln_draw_(wedln, FALSE, completions);
+    }
+}
+
 /*}}} */
 
 
@@ -875,8 +912,10 @@ static void wedln_update_handler(WEdln *wedln, int from, int flags)
     
     from=maxof(0, from-wedln->vstart);
 
-    wedln_draw_str_box(wedln, &geom, wedln->vstart, wedln->edln.p, from,
-                       wedln->edln.point, wedln->edln.mark);
+    if(!window_draw_is_pending((WWindow*)wedln)){
+        wedln_draw_str_box(wedln, &geom, wedln->vstart, wedln->edln.p, 
+                           from, wedln->edln.point, wedln->edln.mark);
+    }
     
     if(update_nocompl==0 &&
        mod_query_config.autoshowcompl && 
@@ -1085,6 +1124,7 @@ static const char *wedln_style(WEdln *wedln)
 
 static DynFunTab wedln_dynfuntab[]={
     {window_draw, wedln_draw},
+    {window_draw_clipped, wedln_draw_clipped},
     {input_calc_size, wedln_calc_size},
     {input_scrollup, wedln_scrollup_completions},
     {input_scrolldown, wedln_scrolldown_completions},
@@ -69,6 +69,7 @@ extern WEdln *create_wedln(WWindow *par, const WFitParams *fp,
 extern void wedln_finish(WEdln *wedln);
 extern void wedln_paste(WEdln *wedln);
 extern void wedln_draw(WEdln *wedln, bool complete);
+extern void wedln_draw_clipped(WEdln *wedln, const WRectangle *clip);
 extern void wedln_set_completions(WEdln *wedln, ExtlTab completions,
                                   bool autoshow_select_first);
 extern void wedln_hide_completions(WEdln *wedln);
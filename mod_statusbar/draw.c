@@ -104,9 +104,20 @@ void statusbar_calculate_xs(WStatusBar *sb)
 
 
 
+static void clear_gap(GrBrush *brush, const WRectangle *g, 
+                      const WRectangle *clip)
+{
+    WRectangle cg=*g;
+    
+    if(clip==NULL || rectangle_intersect(&cg, clip))
+        grbrush_clear_area(brush, &cg);
+}
+
+
+/* If clip is set, elements entirely outside it are skipped. */
 static void draw_elems(GrBrush *brush, WRectangle *g, int ty,
                        WSBElem *elems, int nelems, bool needfill, 
-                       bool complete)
+                       bool complete, const WRectangle *clip)
 {
     int prevx=g->x;
     int maxx=g->x+g->w;
@@ -115,10 +126,14 @@ static void draw_elems(GrBrush *brush, WRectangle *g, int ty,
         if(prevx<elems->x){
             g->x=prevx;
             g->w=elems->x-prevx;
-            grbrush_clear_area(brush, g);
+            clear_gap(brush, g, clip);
         }
-            
-        if(elems->type==WSBELEM_TEXT || elems->type==WSBELEM_METER){
+        
+        if(clip!=NULL && (elems->x>=clip->x+clip->w
+                          || elems->x+elems->text_w<=clip->x)){
+            if(elems->type==WSBELEM_TEXT || elems->type==WSBELEM_METER)
+                prevx=elems->x+elems->text_w;
+        }else if(elems->type==WSBELEM_TEXT || elems->type==WSBELEM_METER){
             const char *s=(elems->text!=NULL
                            ? elems->text 
                            : STATUSBAR_NX_STR);
@@ -140,14 +155,15 @@ static void draw_elems(GrBrush *brush, WRectangle *g, int ty,
     if(prevx<maxx){
         g->x=prevx;
         g->w=maxx-prevx;
-        grbrush_clear_area(brush, g);
+        clear_gap(brush, g, clip);
     }
 }
 
 
-void statusbar_draw(WStatusBar *sb, bool complete)
+static void statusbar_do_draw(WStatusBar *sb, bool complete, 
+                              const WRectangle *clip)
 {
-    WRectangle g;
+    WRectangle g, cg;
     GrBorderWidths bdw;
     GrFontExtents fnte;
     Window win=sb->wwin.win;
@@ -164,12 +180,21 @@ void statusbar_draw(WStatusBar *sb, bool complete)
     g.w=REGION_GEOM(sb).w;
     g.h=REGION_GEOM(sb).h;
     
-    grbrush_begin(sb->brush, &g, (complete ? 0 : GRBRUSH_NO_CLEAR_OK));
+    cg=g;
+    
+    if(clip!=NULL && !rectangle_intersect(&cg, clip))
+        return;
+    
+    grbrush_begin(sb->brush, &cg, 
+                  (complete ? 0 : GRBRUSH_NO_CLEAR_OK)
+                  |(clip!=NULL ? GRBRUSH_NEED_CLIP : 0));
     
     grbrush_draw_border(sb->brush, &g);
     
-    if(sb->elems==NULL)
+    if(sb->elems==NULL){
+        grbrush_end(sb->brush);
         return;
+    }
     
     g.x+=bdw.left;
     g.w-=bdw.left+bdw.right;
@@ -178,9 +203,22 @@ void statusbar_draw(WStatusBar *sb, bool complete)
 
     ty=(g.y+fnte.baseline+(g.h-fnte.max_height)/2);
         
-    draw_elems(sb->brush, &g, ty, sb->elems, sb->nelems, TRUE, complete);
+    draw_elems(sb->brush, &g, ty, sb->elems, sb->nelems, TRUE, complete, 
+               clip);
     
     grbrush_end(sb->brush);
 }
 
 
+void statusbar_draw(WStatusBar *sb, bool complete)
+{
+    statusbar_do_draw(sb, complete, NULL);
+}
+
+
+void statusbar_draw_clipped(WStatusBar *sb, const WRectangle *clip)
+{
+    statusbar_do_draw(sb, FALSE, clip);
+}
+
+
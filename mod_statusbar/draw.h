@@ -13,6 +13,7 @@
 #include "statusbar.h"
 
 extern void statusbar_draw(WStatusBar *sb, bool complete);
+extern void statusbar_draw_clipped(WStatusBar *sb, const WRectangle *clip);
 extern void statusbar_calculate_xs(WStatusBar *sb);
 
 #endif /* ION_MOD_STATUSBAR_DRAW_H */
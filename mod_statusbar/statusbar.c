@@ -910,16 +910,22 @@ void statusbar_update(WStatusBar *sb, ExtlTab t)
                 str=el->text;
             }
             
+            el->text_w=-1;
+            
             if(el->tmpl!=NULL && el->text!=NULL){
-                char *tmp=grbrush_make_label(sb->brush, el->text, el->max_w);
+                uint w;
+                char *tmp=grbrush_make_label2(sb->brush, el->text, 
+                                              el->max_w, &w);
                 if(tmp!=NULL){
                     free(el->text);
                     el->text=tmp;
                     str=tmp;
+                    el->text_w=w;
                 }
             }
 
-            el->text_w=grbrush_get_text_width(sb->brush, str, strlen(str));
+            if(el->text_w<0)
+                el->text_w=grbrush_get_text_width(sb->brush, str, strlen(str));
             
             if(el->text_w>el->max_w && el->tmpl==NULL){
                 el->max_w=el->text_w;
@@ -940,7 +946,7 @@ void statusbar_update(WStatusBar *sb, ExtlTab t)
 
     statusbar_rearrange(sb, grow);
     
-    window_draw((WWindow*)sb, FALSE);
+    window_draw_later((WWindow*)sb, FALSE);
 }
 
 
@@ -967,7 +973,7 @@ void statusbar_updategr(WStatusBar *p)
     statusbar_calc_widths(p);
     statusbar_rearrange(p, TRUE);
     
-    window_draw(&(p->wwin), TRUE);
+    window_draw_later(&(p->wwin), TRUE);
 }
 
 
@@ -1094,6 +1100,7 @@ WRegion *statusbar_load(WWindow *par, const WFitParams *fp, ExtlTab tab)
 
 static DynFunTab statusbar_dynfuntab[]={
     {window_draw, statusbar_draw},
+    {window_draw_clipped, statusbar_draw_clipped},
     {region_updategr, statusbar_updategr},
     {region_size_hints, statusbar_size_hints},
     {(DynFun*)region_orientation, (DynFun*)statusbar_orientation},
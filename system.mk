@@ -98,6 +98,13 @@ DEFINES += -DCF_XFREE86_TEXTPROP_BUG_WORKAROUND
 # Xutf8 routines are broken, in different ways.)
 #DEFINES += -DCF_DE_USE_XUTF8
 
+# Uncomment to build the default drawing engine with Xft (anti-aliased
+# fonts rendered with XRender). Font patterns prefixed with "xft:" are then
+# loaded through Xft, e.g. "xft:Sans-10".
+#USE_XFT=1
+#XFT_INCLUDES=`pkg-config --cflags xft`
+#XFT_LIBS=`pkg-config --libs xft`
+
 # Remap F11 key to SunF36 and F12 to SunF37? You may want to set this
 # on SunOS.
 #DEFINES += -DCF_SUN_F1X_REMAP